@@ -103,6 +103,18 @@ static	int		 validate_urifrag(const char *);
 
 static	const char	 *scriptname = SCRIPT_NAME;
 
+/*
+ * Limits for formatting one manual page, such that a partial page
+ * is shown for hostile input rather than the process getting killed
+ * by the ReDoS timer set up in main().
+ */
+static	const struct mparse_budget budget = {
+	1000,			/* CPU time [ms] */
+	32 * 1024 * 1024,	/* expanded bytes */
+	1000000,		/* nodes */
+	256 * 1024		/* peak memory growth [kB] */
+};
+
 static	const int sec_prios[] = {1, 4, 5, 8, 6, 3, 7, 2, 9};
 static	const char *const sec_numbers[] = {
     "0", "1", "2", "3", "3p", "4", "5", "6", "7", "8", "9"
@@ -916,6 +928,7 @@ resp_format(const struct req *req, const char *file)
 	mchars_alloc();
 	mp = mparse_alloc(MPARSE_SO | MPARSE_UTF8 | MPARSE_LATIN1 |
 	    MPARSE_VALIDATE, MANDOC_OS_OTHER, req->q.manpath);
+	mparse_budget(mp, &budget);
 	mparse_readfd(mp, fd, file);
 	close(fd);
 	meta = mparse_result(mp);
@@ -929,10 +942,12 @@ resp_format(const struct req *req, const char *file)
 	    usepath ? req->q.manpath : "", usepath ? "/" : "");
 
 	vp = html_alloc(&conf);
+	mandoc_stats_stage(MSTAGE_FORMAT);
 	if (meta->macroset == MACROSET_MDOC)
 		html_mdoc(vp, meta);
 	else
 		html_man(vp, meta);
+	mandoc_stats_stage(MSTAGE_NONE);
 
 	html_free(vp);
 	mparse_free(mp);
@@ -1094,6 +1109,8 @@ main(void)
 	const char	*querystring;
 	int		 i;
 
+	mandoc_stats_init();
+
 #if HAVE_PLEDGE
 	/*
 	 * The "rpath" pledge could be revoked after mparse_readfd()
@@ -1185,6 +1202,7 @@ main(void)
 	for (i = 0; i < (int)req.psz; i++)
 		free(req.p[i]);
 	free(req.p);
+	mandoc_stats_finish();
 	return EXIT_SUCCESS;
 }
 
@@ -293,6 +293,24 @@ struct	eqn_def {
 	size_t		  valsz;
 };
 
+/*
+ * Boxes are allocated from chunks holding many of them at once.
+ * Freed boxes are kept on a list for reuse; the chunks are only
+ * released together with the document.
+ */
+#define	EQN_CHUNKSZ	128
+
+struct	eqn_chunk {
+	struct eqn_chunk *next;
+	struct eqn_box	  boxes[EQN_CHUNKSZ];
+};
+
+struct	eqn_pool {
+	struct eqn_chunk *chunks;  /* All chunks, newest first. */
+	struct eqn_box	 *freeboxes; /* Freed boxes available for reuse. */
+	size_t		  chunkused; /* Boxes used in the newest chunk. */
+};
+
 static	struct eqn_box	*eqn_box_alloc(struct eqn_node *, struct eqn_box *);
 static	struct eqn_box	*eqn_box_makebinary(struct eqn_node *,
 				struct eqn_box *);
@@ -304,11 +322,12 @@ static	void		 eqn_undef(struct eqn_node *);
 
 
 struct eqn_node *
-eqn_alloc(void)
+eqn_alloc(struct eqn_pool *pool)
 {
 	struct eqn_node *ep;
 
 	ep = mandoc_calloc(1, sizeof(*ep));
+	ep->pool = pool;
 	ep->gsize = EQN_DEFSIZE;
 	return ep;
 }
@@ -482,31 +501,80 @@ eqn_next(struct eqn_node *ep, enum parse_mode mode)
 	return EQN_TOK__MAX;
 }
 
+struct eqn_pool *
+eqn_pool_alloc(void)
+{
+	return mandoc_calloc(1, sizeof(struct eqn_pool));
+}
+
+/*
+ * Release all chunks of boxes at the end of the document.
+ */
+void
+eqn_pool_reset(struct eqn_pool *pool)
+{
+	struct eqn_chunk	*cp;
+
+	while ((cp = pool->chunks) != NULL) {
+		pool->chunks = cp->next;
+		free(cp);
+	}
+	pool->freeboxes = NULL;
+	pool->chunkused = 0;
+}
+
 void
-eqn_box_free(struct eqn_box *bp)
+eqn_pool_free(struct eqn_pool *pool)
 {
-	if (bp == NULL)
+	if (pool == NULL)
 		return;
+	eqn_pool_reset(pool);
+	free(pool);
+}
 
-	if (bp->first)
-		eqn_box_free(bp->first);
-	if (bp->next)
-		eqn_box_free(bp->next);
+/*
+ * Put a box, its children, and its following siblings
+ * back into the pool of unused boxes, if there is one.
+ */
+void
+eqn_box_free(struct eqn_pool *pool, struct eqn_box *bp)
+{
+	struct eqn_box	*next;
 
-	free(bp->text);
-	free(bp->left);
-	free(bp->right);
-	free(bp->top);
-	free(bp->bottom);
-	free(bp);
+	for (; bp != NULL; bp = next) {
+		next = bp->next;
+		eqn_box_free(pool, bp->first);
+		free(bp->text);
+		free(bp->left);
+		free(bp->right);
+		free(bp->top);
+		free(bp->bottom);
+		if (pool != NULL) {
+			bp->next = pool->freeboxes;
+			pool->freeboxes = bp;
+		}
+	}
 }
 
 struct eqn_box *
-eqn_box_new(void)
+eqn_box_new(struct eqn_pool *pool)
 {
-	struct eqn_box	*bp;
+	struct eqn_chunk	*cp;
+	struct eqn_box		*bp;
 
-	bp = mandoc_calloc(1, sizeof(*bp));
+	if ((bp = pool->freeboxes) != NULL)
+		pool->freeboxes = bp->next;
+	else {
+		if (pool->chunks == NULL ||
+		    pool->chunkused == EQN_CHUNKSZ) {
+			cp = mandoc_malloc(sizeof(*cp));
+			cp->next = pool->chunks;
+			pool->chunks = cp;
+			pool->chunkused = 0;
+		}
+		bp = pool->chunks->boxes + pool->chunkused++;
+	}
+	memset(bp, 0, sizeof(*bp));
 	bp->expectargs = UINT_MAX;
 	return bp;
 }
@@ -519,7 +587,7 @@ eqn_box_alloc(struct eqn_node *ep, struct eqn_box *parent)
 {
 	struct eqn_box	*bp;
 
-	bp = eqn_box_new();
+	bp = eqn_box_new(ep->pool);
 	bp->parent = parent;
 	bp->parent->args++;
 	bp->font = bp->parent->font;
@@ -22,10 +22,12 @@
 struct roff_node;
 struct eqn_box;
 struct eqn_def;
+struct eqn_pool;
 
 struct	eqn_node {
 	struct roff_node *node;    /* Syntax tree of this equation. */
 	struct eqn_def	 *defs;    /* Array of definitions. */
+	struct eqn_pool	 *pool;    /* Memory for the boxes. */
 	char		 *data;    /* Source code of this equation. */
 	char		 *start;   /* First byte of the current token. */
 	char		 *end;	   /* First byte of the next token. */
@@ -41,9 +43,12 @@ struct	eqn_node {
 };
 
 
-struct eqn_node	*eqn_alloc(void);
-struct eqn_box	*eqn_box_new(void);
-void		 eqn_box_free(struct eqn_box *);
+struct eqn_node	*eqn_alloc(struct eqn_pool *);
+struct eqn_box	*eqn_box_new(struct eqn_pool *);
+void		 eqn_box_free(struct eqn_pool *, struct eqn_box *);
+struct eqn_pool	*eqn_pool_alloc(void);
+void		 eqn_pool_free(struct eqn_pool *);
+void		 eqn_pool_reset(struct eqn_pool *);
 void		 eqn_free(struct eqn_node *);
 void		 eqn_parse(struct eqn_node *);
 void		 eqn_read(struct eqn_node *, const char *);
@@ -74,6 +74,7 @@ void		 roff_man_free(struct roff_man *);
 struct roff_man	*roff_man_alloc(struct roff *, const char *, int);
 void		 roff_man_reset(struct roff_man *);
 int		 roff_parseln(struct roff *, int, struct buf *, int *, size_t);
+struct buf	*roff_userlines(struct roff *);
 void		 roff_userret(struct roff *);
 void		 roff_endparse(struct roff *);
 void		 roff_setreg(struct roff *, const char *, int, char);
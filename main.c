@@ -89,6 +89,9 @@ struct	outstate {
 	char		**argv;		/* Pager and arguments. */
 	int		  argc;		/* Number of pager arguments. */
 	int		  use_pager;
+	int		  use_pipe;	/* Stream output to the pager. */
+	int		  use_stream;	/* Print sections while parsing. */
+	int		  had_stream;	/* Messages may be inside output. */
 	int		  wstop;	/* stop after a file with a warning */
 	int		  had_output;	/* Some output was generated. */
 	enum outt	  outtype;	/* which output to use */
@@ -111,6 +114,8 @@ static	void		  glob_esc(char **, const char *, const char *);
 static	void		  outdata_alloc(struct outstate *, struct manoutput *);
 static	void		  parse(struct mparse *, int, const char *,
 				struct outstate *, struct manconf *, int);
+static	void		  parse_part(void *, const struct roff_meta *,
+				struct roff_node *);
 static	void		  passthrough(int, int);
 static	void		  process_onefile(struct mparse *, struct manpage *,
 				struct outstate *, struct manconf *, int);
@@ -135,6 +140,7 @@ main(int argc, char *argv[])
 	struct manpage	*res;		/* Complete list of search results. */
 	struct manpage	*resn;		/* Search results for one name. */
 	struct mparse	*mp;		/* Opaque parser object. */
+	struct mparse_budget budget;	/* -I: Limits per document. */
 	const char	*conf_file;	/* -C: alternate config file. */
 	const char	*os_s;		/* -I: Operating system for display. */
 	const char	*progname, *sec, *ep;
@@ -157,6 +163,7 @@ main(int argc, char *argv[])
 #if DEBUG_MEMORY
 	mandoc_dbg_init(argc, argv);
 #endif
+	mandoc_stats_init();
 #if HAVE_PROGNAME
 	progname = getprogname();
 #else
@@ -171,8 +178,11 @@ main(int argc, char *argv[])
 
 	mandoc_msg_setoutfile(stderr);
 	if (strncmp(progname, "mandocdb", 8) == 0 ||
-	    strcmp(progname, BINM_MAKEWHATIS) == 0)
-		return mandocdb(argc, argv);
+	    strcmp(progname, BINM_MAKEWHATIS) == 0) {
+		c = mandocdb(argc, argv);
+		mandoc_stats_finish();
+		return c;
+	}
 
 #if HAVE_SANDBOX_INIT
 	if (sandbox_init(kSBXProfileNoInternet, SANDBOX_NAMED, NULL) == -1)
@@ -187,6 +197,7 @@ main(int argc, char *argv[])
 
 	memset(&search, 0, sizeof(struct mansearch));
 	search.outkey = "Nd";
+	memset(&budget, 0, sizeof(budget));
 	oarg = NULL;
 
 	if (strcmp(progname, BINM_MAN) == 0)
@@ -242,6 +253,8 @@ main(int argc, char *argv[])
 			break;
 		case 'I':
 			if (strncmp(optarg, "os=", 3) != 0) {
+				if (mparse_budget_arg(&budget, optarg) == 0)
+					break;
 				mandoc_msg(MANDOCERR_BADARG_BAD, 0, 0,
 				    "-I %s", optarg);
 				return mandoc_msg_getrc();
@@ -375,6 +388,20 @@ main(int argc, char *argv[])
 	if (outst.outtype != OUTT_TREE || conf.output.noval == 0)
 		options |= MPARSE_VALIDATE;
 
+	/* The terminal formatters use pre-decoded escape sequences. */
+
+	switch (outst.outtype) {
+	case OUTT_ASCII:
+	case OUTT_LOCALE:
+	case OUTT_UTF8:
+	case OUTT_PS:
+	case OUTT_PDF:
+		options |= MPARSE_ESCAPES;
+		break;
+	default:
+		break;
+	}
+
 	if (outmode == OUTMODE_FLN ||
 	    outmode == OUTMODE_LST ||
 	    (conf.output.outfilename == NULL &&
@@ -460,6 +487,16 @@ main(int argc, char *argv[])
 
 	/* Set up output files, including temporary ones. */
 
+	if (outst.use_pager && conf.output.pipe &&
+	    outst.outtype <= OUTT_UTF8 &&
+	    conf.output.outfilename == NULL &&
+	    conf.output.tagfilename == NULL &&
+	    conf.output.tag == NULL)
+		outst.use_pipe = 1;
+
+	if (conf.output.stream && outst.outtype <= OUTT_UTF8)
+		outst.use_stream = 1;
+
 	if (outst.use_pager) {
 #if HAVE_UNVEIL
 		if (conf.output.outfilename == NULL ||
@@ -487,7 +524,9 @@ main(int argc, char *argv[])
 #endif
 		outst.tag_files = term_tag_init(conf.output.outfilename,
 		    outst.outtype == OUTT_HTML ? ".html" : "",
-		    conf.output.tagfilename);
+		    conf.output.tagfilename, outst.use_pipe);
+		if (outst.tag_files == NULL)
+			outst.use_pipe = 0;
 	}
 
 #if HAVE_PLEDGE
@@ -699,6 +738,7 @@ main(int argc, char *argv[])
 
 	mchars_alloc();
 	mp = mparse_alloc(options, os_e, os_s);
+	mparse_budget(mp, &budget);
 
 	startdir = -1;
 	if (search.argmode == ARG_FILE &&
@@ -772,7 +812,8 @@ out:
 			run_pager(&outst, conf.output.tag);
 		term_tag_unlink();
 	} else if (outst.had_output && outst.outtype != OUTT_LINT)
-		mandoc_msg_summary();
+		mandoc_msg_summary(outst.had_stream);
+	mandoc_stats_finish();
 
 #if DEBUG_MEMORY
 	mandoc_dbg_finish();
@@ -785,9 +826,10 @@ usage(enum argmode argmode)
 {
 	switch (argmode) {
 	case ARG_FILE:
-		fputs("usage: mandoc [-ac] [-I os=name] "
-		    "[-K encoding] [-mdoc | -man] [-O options]\n"
-		    "\t      [-T output] [-W level] [file ...]\n", stderr);
+		fputs("usage: mandoc [-ac] [-I os=name] [-I budget=limit] "
+		    "[-K encoding]\n"
+		    "\t      [-mdoc | -man] [-O options] [-T output] "
+		    "[-W level] [file ...]\n", stderr);
 		break;
 	case ARG_NAME:
 		fputs("usage: man [-acfhklw] [-C file] [-M path] "
@@ -990,12 +1032,19 @@ process_onefile(struct mparse *mp, struct manpage *resp,
 			mandoc_msg(resp->ipath == SIZE_MAX ?
 			    MANDOCERR_BADARG_BAD : MANDOCERR_OPEN,
 			    0, 0, "%s", strerror(errno));
+			mandoc_msg_flush();
 			mandoc_msg_setinfilename(NULL);
 			return;
 		}
 	} else
 		fd = STDIN_FILENO;
 
+	/* With -O pipe, start the pager before the first output. */
+
+	if (outst->use_pipe && outst->tag_files != NULL &&
+	    outst->tag_files->pager_pid == 0)
+		(void)spawn_pager(outst, NULL);
+
 	if (outst->had_output && outst->outtype <= OUTT_UTF8) {
 		if (outst->outdata == NULL)
 			outdata_alloc(outst, &conf->output);
@@ -1009,6 +1058,8 @@ process_onefile(struct mparse *mp, struct manpage *resp,
 		outst->had_output = 1;
 	}
 
+	if (outst->tag_files != NULL)
+		term_tag_check();
 	if (ferror(stdout)) {
 		if (outst->tag_files != NULL) {
 			mandoc_msg(MANDOCERR_WRITE, 0, 0, "%s: %s",
@@ -1019,6 +1070,7 @@ process_onefile(struct mparse *mp, struct manpage *resp,
 			mandoc_msg(MANDOCERR_WRITE, 0, 0, "%s",
 			    strerror(errno));
 	}
+	mandoc_msg_flush();
 	mandoc_msg_setinfilename(NULL);
 }
 
@@ -1027,11 +1079,40 @@ parse(struct mparse *mp, int fd, const char *file,
     struct outstate *outst, struct manconf *conf, int startdir)
 {
 	struct roff_meta	*meta;
+	enum mandoc_stage	 stage;
 
 	assert(fd >= 0);
 	if (file == NULL)
 		file = "<stdin>";
 
+	/*
+	 * With -O stream, start printing completed sections
+	 * while the rest of the file is still being parsed.
+	 * That is impossible with -Wstop, which may suppress
+	 * output after seeing a problem near the end.
+	 */
+
+	mandoc_xr_reset();
+	if (outst->use_stream && outst->wstop == 0 &&
+	    conf->output.synopsisonly == 0) {
+		if (outst->outdata == NULL)
+			outdata_alloc(outst, &conf->output);
+		mparse_stream(mp, parse_part, outst);
+	} else
+		mparse_stream(mp, NULL, NULL);
+
+	/*
+	 * When printing the synopsis only, do not build and validate
+	 * other sections, and stop reading after the SYNOPSIS.
+	 * The NAME section is needed as a fallback and for .Nm.
+	 */
+
+	if (outst->outtype <= OUTT_UTF8 && outst->wstop == 0 &&
+	    conf->output.synopsisonly)
+		mparse_sections(mp, 1U << SEC_NAME | 1U << SEC_SYNOPSIS);
+	else
+		mparse_sections(mp, 0);
+
 	mparse_readfd(mp, fd, file);
 	if (fd != STDIN_FILENO)
 		close(fd);
@@ -1049,11 +1130,11 @@ parse(struct mparse *mp, int fd, const char *file,
 	else if (outst->outtype == OUTT_HTML)
 		html_reset(outst->outdata);
 
-	mandoc_xr_reset();
 	meta = mparse_result(mp);
 
 	/* Execute the out device, if it exists. */
 
+	stage = mandoc_stats_stage(MSTAGE_FORMAT);
 	outst->had_output = 1;
 	if (meta->macroset == MACROSET_MDOC) {
 		switch (outst->outtype) {
@@ -1105,6 +1186,7 @@ parse(struct mparse *mp, int fd, const char *file,
 			break;
 		}
 	}
+	mandoc_stats_stage(stage);
 	if (conf->output.tag != NULL && conf->output.tag_found == 0 &&
 	    tag_exists(conf->output.tag))
 		conf->output.tag_found = 1;
@@ -1115,6 +1197,33 @@ parse(struct mparse *mp, int fd, const char *file,
 		check_xr(&conf->manpath, startdir);
 }
 
+/*
+ * Print sections that the parser completed early.
+ * The rest of the document is printed by parse().
+ */
+static void
+parse_part(void *arg, const struct roff_meta *meta, struct roff_node *n)
+{
+	struct outstate		*outst;
+	enum mandoc_stage	 stage;
+	int			 printed;
+
+	outst = arg;
+	stage = mandoc_stats_stage(MSTAGE_FORMAT);
+	if (meta->macroset == MACROSET_MDOC)
+		printed = terminal_mdoc_part(outst->outdata, meta, n);
+	else
+		printed = terminal_man_part(outst->outdata, meta, n);
+	if (printed) {
+		outst->had_output = 1;
+		outst->had_stream = 1;
+		fflush(stdout);
+		if (outst->tag_files != NULL)
+			term_tag_check();
+	}
+	mandoc_stats_stage(stage);
+}
+
 static void
 check_xr(struct manpaths *paths, int startdir)
 {
@@ -1239,7 +1348,7 @@ static int
 woptions(char *arg, enum mandoc_os *os_e, int *wstop)
 {
 	char		*v, *o;
-	const char	*toks[11];
+	const char	*toks[12];
 
 	toks[0] = "stop";
 	toks[1] = "all";
@@ -1251,7 +1360,8 @@ woptions(char *arg, enum mandoc_os *os_e, int *wstop)
 	toks[7] = "fatal";
 	toks[8] = "openbsd";
 	toks[9] = "netbsd";
-	toks[10] = NULL;
+	toks[10] = "collapse";
+	toks[11] = NULL;
 
 	while (*arg) {
 		o = arg;
@@ -1286,6 +1396,9 @@ woptions(char *arg, enum mandoc_os *os_e, int *wstop)
 			mandoc_msg_setmin(MANDOCERR_BASE);
 			*os_e = MANDOC_OS_NETBSD;
 			break;
+		case 10:
+			mandoc_msg_setcollapse(1);
+			break;
 		default:
 			mandoc_msg(MANDOCERR_BADARG_BAD, 0, 0, "-W %s", o);
 			return -1;
@@ -1386,6 +1499,24 @@ run_pager(struct outstate *outst, char *tag_target)
 	pid_t	 man_pgid, tc_pgid;
 	pid_t	 pager_pid, wait_pid;
 
+	/*
+	 * A pager reading from a pipe was started early and shares
+	 * the process group of man(1); closing the pipe in
+	 * term_tag_close() let it see the end of the input.
+	 */
+
+	if (outst->use_pipe) {
+		if (outst->tag_files->pager_pid == 0)
+			return;
+		while (waitpid(outst->tag_files->pager_pid, &status, 0) == -1)
+			if (errno != EINTR) {
+				mandoc_msg(MANDOCERR_WAIT, 0, 0,
+				    "%s", strerror(errno));
+				break;
+			}
+		return;
+	}
+
 	man_pgid = getpgid(0);
 	outst->tag_files->tcpgid =
 	    man_pgid == getpid() ? getpgid(getppid()) : man_pgid;
@@ -1441,15 +1572,20 @@ spawn_pager(struct outstate *outst, char *tag_target)
 #if HAVE_LESS_T
 	size_t		 cmdlen;
 #endif
+	int		 fds[2];	/* Pipe for -O pipe mode. */
 	int		 use_ofn;
 	pid_t		 pager_pid;
 
-	assert(outst->tag_files->ofd == -1);
-	assert(outst->tag_files->tfs == NULL);
+	if (outst->use_pipe)
+		assert(outst->tag_files->ofd != -1);
+	else {
+		assert(outst->tag_files->ofd == -1);
+		assert(outst->tag_files->tfs == NULL);
+	}
 
 	/* For less(1), use the tag file. */
 
-	use_ofn = 1;
+	use_ofn = outst->use_pipe == 0;
 #if HAVE_LESS_T
 	if (*outst->tag_files->tfn != '\0' &&
 	    (cmdlen = strlen(outst->argv[0])) >= 4) {
@@ -1480,6 +1616,11 @@ spawn_pager(struct outstate *outst, char *tag_target)
 	}
 	outst->argv[outst->argc] = NULL;
 
+	if (outst->use_pipe && pipe(fds) == -1) {
+		mandoc_msg(MANDOCERR_PIPE, 0, 0, "%s", strerror(errno));
+		exit(mandoc_msg_getrc());
+	}
+
 	switch (pager_pid = fork()) {
 	case -1:
 		mandoc_msg(MANDOCERR_FORK, 0, 0, "%s", strerror(errno));
@@ -1489,6 +1630,32 @@ spawn_pager(struct outstate *outst, char *tag_target)
 	default:
 		while (outst->argc > 0)
 			free(outst->argv[--outst->argc]);
+		outst->tag_files->pager_pid = pager_pid;
+
+		/*
+		 * Keep the pager in the process group of man(1),
+		 * like a shell pipeline, such that job control
+		 * stops and continues both together.
+		 */
+
+		if (outst->use_pipe) {
+			close(fds[0]);
+			if (dup2(fds[1], STDOUT_FILENO) == -1) {
+				mandoc_msg(MANDOCERR_DUP, 0, 0,
+				    "%s", strerror(errno));
+				exit(mandoc_msg_getrc());
+			}
+			close(fds[1]);
+#if HAVE_PLEDGE
+			/* Needed to read manuals and term_tag_unlink(). */
+			if (pledge("stdio rpath cpath", NULL) == -1) {
+				mandoc_msg(MANDOCERR_PLEDGE, 0, 0,
+				    "%s", strerror(errno));
+				exit(mandoc_msg_getrc());
+			}
+#endif
+			return pager_pid;
+		}
 		(void)setpgid(pager_pid, 0);
 		(void)tcsetpgrp(STDOUT_FILENO, pager_pid);
 
@@ -1500,17 +1667,27 @@ spawn_pager(struct outstate *outst, char *tag_target)
 			exit(mandoc_msg_getrc());
 		}
 #endif
-		outst->tag_files->pager_pid = pager_pid;
 		return pager_pid;
 	}
 
 	/*
 	 * The child process becomes the pager.
-	 * Do not start it before controlling the terminal.
+	 * With -O pipe, it reads the formatted text from the pipe
+	 * and writes to the original standard output.
+	 * Otherwise, do not start it before controlling the terminal.
 	 */
 
-	while (tcgetpgrp(STDOUT_FILENO) != getpid())
-		nanosleep(&timeout, NULL);
+	if (outst->use_pipe) {
+		close(fds[1]);
+		if (dup2(fds[0], STDIN_FILENO) == -1) {
+			mandoc_msg(MANDOCERR_DUP, 0, 0, "%s", strerror(errno));
+			_exit(mandoc_msg_getrc());
+		}
+		close(fds[0]);
+		close(outst->tag_files->ofd);
+	} else
+		while (tcgetpgrp(STDOUT_FILENO) != getpid())
+			nanosleep(&timeout, NULL);
 
 	execv(outst->argv[0], outst->argv);
 	mandoc_msg(MANDOCERR_EXEC, 0, 0, "%s: %s",
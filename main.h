@@ -17,6 +17,7 @@
  */
 
 struct	roff_meta;
+struct	roff_node;
 struct	manoutput;
 
 /*
@@ -41,13 +42,18 @@ void		 *locale_alloc(const struct manoutput *);
 void		 *utf8_alloc(const struct manoutput *);
 void		 *ascii_alloc(const struct manoutput *);
 void		  ascii_free(void *);
+void		  ascii_setmem(void *, char **, size_t *);
 
 void		 *pdf_alloc(const struct manoutput *);
 void		 *ps_alloc(const struct manoutput *);
 void		  pspdf_free(void *);
 
 void		  terminal_mdoc(void *, const struct roff_meta *);
+int		  terminal_mdoc_part(void *, const struct roff_meta *,
+			struct roff_node *);
 void		  terminal_man(void *, const struct roff_meta *);
+int		  terminal_man_part(void *, const struct roff_meta *,
+			struct roff_node *);
 void		  terminal_sepline(void *);
 
 void		  markdown_mdoc(void *, const struct roff_meta *);
@@ -131,7 +131,8 @@ man_ptext(struct roff_man *man, int line, char *buf, int offs)
 			return 1;
 		if (man->last->type == ROFFT_TEXT &&
 		    ((ep = man_hasc(man->last->string)) != NULL)) {
-			*ep = '\0';
+			i = ep - man->last->string;
+			roff_word_own(man->last)[i] = '\0';
 			return 1;
 		}
 		mandoc_msg(MANDOCERR_FI_BLANK, line, i, NULL);
@@ -19,3 +19,4 @@
 struct	roff_man;
 
 void			 man_validate(struct roff_man *);
+void			 man_validate_root(struct roff_man *);
@@ -61,6 +61,8 @@ struct	man_term_act {
 #define	MAN_NOTEXT	 (1 << 0) /* Never has text children. */
 };
 
+static	void		  print_man_begin(struct termp *,
+				const struct roff_meta *, struct mtermp *);
 static	void		  print_man_nodelist(DECL_ARGS);
 static	void		  print_man_node(DECL_ARGS);
 static	void		  print_man_head(struct termp *,
@@ -156,23 +158,27 @@ terminal_man(void *arg, const struct roff_meta *man)
 	struct roff_node	*n, *nc, *nn;
 
 	p = (struct termp *)arg;
-	p->tcol->rmargin = p->maxrmargin = p->defrmargin;
-	term_tab_set(p, NULL);
-	term_tab_set(p, "T");
-	term_tab_set(p, ".5i");
 
-	memset(&mt, 0, sizeof(mt));
-	mt.lmargin[mt.lmargincur] = term_len(p, 7);
-	mt.offset = term_len(p, p->defindent);
-	mt.pardist = 1;
+	/* Finish a document that was partly printed while parsing. */
+
+	if (p->lastpart != NULL) {
+		print_man_nodelist(p, p->mt, p->lastpart->next, man);
+		p->lastpart = NULL;
+		free(p->mt);
+		p->mt = NULL;
+		term_end(p);
+		term_tag_flush();
+		return;
+	}
 
+	print_man_begin(p, man, &mt);
 	n = man->first->child;
 	if (p->synopsisonly) {
 		for (nn = NULL; n != NULL; n = n->next) {
 			if (n->tok != MAN_SH)
 				continue;
 			nc = n->child->child;
-			if (nc->type != ROFFT_TEXT)
+			if (nc == NULL || nc->type != ROFFT_TEXT)
 				continue;
 			if (strcmp(nc->string, "SYNOPSIS") == 0)
 				break;
@@ -186,12 +192,70 @@ terminal_man(void *arg, const struct roff_meta *man)
 			print_man_nodelist(p, &mt, n, man);
 		term_newln(p);
 	} else {
-		term_begin(p, print_man_head, print_man_foot, man);
-		p->flags |= TERMP_NOSPACE;
 		if (n != NULL)
 			print_man_nodelist(p, &mt, n, man);
 		term_end(p);
 	}
+	term_tag_flush();
+}
+
+/*
+ * Print the top level nodes up to and including the node last
+ * while the rest of the document is still being parsed.
+ * The page header is only printed once the title is known;
+ * until then, do nothing, return 0, and let terminal_man() start over.
+ */
+int
+terminal_man_part(void *arg, const struct roff_meta *man,
+    struct roff_node *last)
+{
+	struct roff_node	*n;
+	struct termp		*p;
+
+	p = (struct termp *)arg;
+	if (p->lastpart == NULL) {
+		if (p->synopsisonly ||
+		    man->title == NULL || man->msec == NULL)
+			return 0;
+		p->mt = mandoc_malloc(sizeof(*p->mt));
+		print_man_begin(p, man, p->mt);
+		n = man->first->child;
+	} else
+		n = p->lastpart->next;
+
+	for (;;) {
+		print_man_node(p, p->mt, n, man);
+		if (n == last)
+			break;
+		n = n->next;
+	}
+	p->lastpart = last;
+	return 1;
+}
+
+/*
+ * Set up margins, tab stops, and the man(7) state mt
+ * for a new document and, unless only the synopsis
+ * is wanted, print the page header.
+ */
+static void
+print_man_begin(struct termp *p, const struct roff_meta *man,
+    struct mtermp *mt)
+{
+	p->tcol->rmargin = p->maxrmargin = p->defrmargin;
+	term_tab_set(p, NULL);
+	term_tab_set(p, "T");
+	term_tab_set(p, ".5i");
+
+	memset(mt, 0, sizeof(*mt));
+	mt->lmargin[mt->lmargincur] = term_len(p, 7);
+	mt->offset = term_len(p, p->defindent);
+	mt->pardist = 1;
+
+	if (p->synopsisonly)
+		return;
+	term_begin(p, print_man_head, print_man_foot, man);
+	p->flags |= TERMP_NOSPACE;
 }
 
 /*
@@ -952,7 +1016,7 @@ print_man_node(DECL_ARGS)
 		else if (n->flags & NODE_DELIMC)
 			p->flags |= TERMP_NOSPACE;
 
-		term_word(p, n->string);
+		term_word_esc(p, n->string, n->esc);
 		goto out;
 	case ROFFT_COMMENT:
 		return;
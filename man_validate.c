@@ -158,6 +158,18 @@ man_validate(struct roff_man *man)
 	}
 }
 
+/*
+ * Validate the root node only, for use when all its children
+ * were already validated one by one.
+ */
+void
+man_validate_root(struct roff_man *man)
+{
+	man->last = man->meta.first;
+	man->next = ROFF_NEXT_SIBLING;
+	check_root(man, man->last);
+}
+
 static void
 check_root(CHKARGS)
 {
@@ -671,6 +683,6 @@ post_in(CHKARGS)
 	    *n->child->string == '-')
 		return;
 	mandoc_asprintf(&s, "+%s", n->child->string);
-	free(n->child->string);
+	free(roff_word_own(n->child));
 	n->child->string = s;
 }
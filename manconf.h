@@ -42,6 +42,8 @@ struct	manoutput {
 	int	  fragment;
 	int	  mdoc;
 	int	  noval;
+	int	  pipe;
+	int	  stream;
 	int	  synopsisonly;
 	int	  tag_found;
 	int	  toc;
@@ -19,6 +19,8 @@
  * Can be used by all code in the mandoc package.
  */
 
+struct	rusage;
+
 #define ASCII_NBRSP	 31  /* non-breaking space */
 #define ASCII_NBRZW	 30  /* non-breaking zero-width space */
 #define ASCII_BREAK	 29  /* breakable zero-width space */
@@ -204,6 +206,7 @@ enum	mandocerr {
 	MANDOCERR_PROLOG_REP, /* duplicate prologue macro: macro */
 	MANDOCERR_DT_LATE, /* skipping late title macro: Dt args */
 	MANDOCERR_ROFFLOOP, /* input stack limit exceeded, infinite loop? */
+	MANDOCERR_BUDGET, /* parse budget exceeded, stopping: name=limit */
 	MANDOCERR_CHAR_BAD, /* skipping bad character: number */
 	MANDOCERR_MACRO, /* skipping unknown macro: macro */
 	MANDOCERR_REQ_NOMAC, /* skipping request outside macro: ... */
@@ -286,6 +289,7 @@ enum	mandocerr {
 	MANDOCERR_MKSTEMP,
 	MANDOCERR_OPEN,
 	MANDOCERR_PATH,
+	MANDOCERR_PIPE,
 	MANDOCERR_PLEDGE,
 	MANDOCERR_READ,
 	MANDOCERR_UNVEIL,
@@ -322,10 +326,45 @@ enum	mandoc_esc {
 	ESCAPE_OVERSTRIKE /* overstrike all chars in the argument */
 };
 
+enum	mandoc_stage {
+	MSTAGE_NONE = 0, /* none of the following */
+	MSTAGE_READ, /* reading and decompressing files */
+	MSTAGE_LINE, /* splitting input into lines, encodings */
+	MSTAGE_ROFF, /* roff(7) requests and escape sequences */
+	MSTAGE_MACRO, /* mdoc(7) and man(7) macros */
+	MSTAGE_VALIDATE, /* validation of the syntax tree */
+	MSTAGE_POST, /* tags and decoding of text nodes */
+	MSTAGE_FORMAT, /* formatting and output */
+	MSTAGE_MAX
+};
+
+enum	mandoc_count {
+	MCOUNT_FILES = 0, /* input files read, including .so */
+	MCOUNT_BYTES, /* input bytes after decompression */
+	MCOUNT_LINES, /* input lines */
+	MCOUNT_NODES, /* syntax tree nodes */
+	MCOUNT_ESCAPES, /* escape sequences interpolated by roff */
+	MCOUNT_MACROS, /* calls of user-defined macros */
+	MCOUNT_ALLOCS, /* calls of mandoc_malloc(3) and friends */
+	MCOUNT_MAX
+};
+
+/*
+ * Function receiving messages instead of the output file,
+ * with the arguments: opaque pointer, level, type, input file name,
+ * line, column, message argument or NULL, and number of occurrences.
+ */
+typedef	void	(*mandoc_msg_handler)(void *, enum mandoclevel,
+			enum mandocerr, const char *, int, int,
+			const char *, unsigned int);
+
 
 enum mandoc_esc	  mandoc_font(const char *, int);
 enum mandoc_esc	  mandoc_escape(const char **, const char **, int *);
 void		  mandoc_msg_setoutfile(FILE *);
+void		  mandoc_msg_sethandler(mandoc_msg_handler, void *);
+void		  mandoc_msg_setcollapse(int);
+void		  mandoc_msg_flush(void);
 const char	 *mandoc_msg_getinfilename(void);
 void		  mandoc_msg_setinfilename(const char *);
 enum mandocerr	  mandoc_msg_getmin(void);
@@ -334,7 +373,15 @@ enum mandoclevel  mandoc_msg_getrc(void);
 void		  mandoc_msg_setrc(enum mandoclevel);
 void		  mandoc_msg(enum mandocerr, int, int, const char *, ...)
 			__attribute__((__format__ (__printf__, 4, 5)));
-void		  mandoc_msg_summary(void);
+void		  mandoc_msg_summary(int);
+void		  mandoc_stats_init(void);
+void		  mandoc_stats_start(FILE *);
+enum mandoc_stage mandoc_stats_stage(enum mandoc_stage);
+enum mandoc_stage mandoc_stats_current(void);
+const char	 *mandoc_stats_name(enum mandoc_stage);
+void		  mandoc_stats_count(enum mandoc_count, size_t);
+long		  mandoc_stats_maxrss(const struct rusage *);
+void		  mandoc_stats_finish(void);
 void		  mchars_alloc(void);
 void		  mchars_free(void);
 int		  mchars_num2char(const char *, size_t);
@@ -38,6 +38,7 @@ mandoc_asprintf(char **dest, const char *fmt, ...)
 	va_list	 ap;
 	int	 ret;
 
+	mandoc_stats_count(MCOUNT_ALLOCS, 1);
 	va_start(ap, fmt);
 	ret = vasprintf(dest, fmt, ap);
 	va_end(ap);
@@ -52,6 +53,7 @@ mandoc_calloc(size_t num, size_t size)
 {
 	void	*ptr;
 
+	mandoc_stats_count(MCOUNT_ALLOCS, 1);
 	ptr = calloc(num, size);
 	if (ptr == NULL)
 		err((int)MANDOCLEVEL_SYSERR, NULL);
@@ -63,6 +65,7 @@ mandoc_malloc(size_t size)
 {
 	void	*ptr;
 
+	mandoc_stats_count(MCOUNT_ALLOCS, 1);
 	ptr = malloc(size);
 	if (ptr == NULL)
 		err((int)MANDOCLEVEL_SYSERR, NULL);
@@ -72,6 +75,7 @@ mandoc_malloc(size_t size)
 void *
 mandoc_realloc(void *ptr, size_t size)
 {
+	mandoc_stats_count(MCOUNT_ALLOCS, 1);
 	ptr = realloc(ptr, size);
 	if (ptr == NULL)
 		err((int)MANDOCLEVEL_SYSERR, NULL);
@@ -81,6 +85,7 @@ mandoc_realloc(void *ptr, size_t size)
 void *
 mandoc_reallocarray(void *ptr, size_t num, size_t size)
 {
+	mandoc_stats_count(MCOUNT_ALLOCS, 1);
 	ptr = reallocarray(ptr, num, size);
 	if (ptr == NULL)
 		err((int)MANDOCLEVEL_SYSERR, NULL);
@@ -90,6 +95,7 @@ mandoc_reallocarray(void *ptr, size_t num, size_t size)
 void *
 mandoc_recallocarray(void *ptr, size_t oldnum, size_t num, size_t size)
 {
+	mandoc_stats_count(MCOUNT_ALLOCS, 1);
 	ptr = recallocarray(ptr, oldnum, num, size);
 	if (ptr == NULL)
 		err((int)MANDOCLEVEL_SYSERR, NULL);
@@ -101,6 +107,7 @@ mandoc_strdup(const char *ptr)
 {
 	char	*p;
 
+	mandoc_stats_count(MCOUNT_ALLOCS, 1);
 	p = strdup(ptr);
 	if (p == NULL)
 		err((int)MANDOCLEVEL_SYSERR, NULL);
@@ -112,6 +119,7 @@ mandoc_strndup(const char *ptr, size_t sz)
 {
 	char	*p;
 
+	mandoc_stats_count(MCOUNT_ALLOCS, 1);
 	p = strndup(ptr, sz);
 	if (p == NULL)
 		err((int)MANDOCLEVEL_SYSERR, NULL);
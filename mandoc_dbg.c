@@ -49,15 +49,37 @@ struct dhash_entry {
 	void		*ptr;
 };
 
+/* Store the allocation profile of one call site. */
+struct dsite_entry {
+	const char	*file;		/* Key, together with line. */
+	int		 line;
+	const char	*func;
+	size_t		 count[MSTAGE_MAX];
+	size_t		 bytes[MSTAGE_MAX];
+	size_t		 total;		/* Sum of bytes[], for sorting. */
+};
+
+/* Number of power-of-two size classes in the histogram. */
+#define	DHIST_MAX	(sizeof(size_t) * 8 + 1)
+
 /* Store information about all allocations. */
 static struct ohash	  dhash_table;
 static FILE		 *dhash_fp;
 static int		  dhash_aflag;
+static int		  dhash_cflag;
 static int		  dhash_fflag;
 static int		  dhash_lflag;
 static int		  dhash_nflag;
+static int		  dhash_rflag;
 static int		  dhash_sflag;
 
+/* Store the allocation profile for the C and R flags. */
+static struct ohash	  dsite_table;
+static size_t		  dhist_count[DHIST_MAX];
+static size_t		  dhist_bytes[DHIST_MAX];
+static size_t		  dhash_live;	/* Bytes allocated and not freed. */
+static size_t		  dhash_peak;	/* Maximum of dhash_live. */
+
 static	void		 *dhash_alloc(size_t, void *);
 static	void		 *dhash_calloc(size_t, size_t, void *);
 static	void		  dhash_free(void *, void *);
@@ -66,6 +88,10 @@ static	void		  dhash_register(const char *, int, const char *,
 				size_t, size_t, void *, const char *);
 static	void		  dhash_print(struct dhash_entry *);
 static	void		  dhash_purge(const char *, int, const char *, void *);
+static	void		  dsite_register(const char *, int, const char *,
+				size_t);
+static	int		  dsite_cmp(const void *, const void *);
+static	void		  dsite_report(void);
 
 
 /* *** Debugging wrappers of public API functions. ************************ */
@@ -196,6 +222,8 @@ mandoc_dbg_init(int argc, char *argv[])
 	info.data = NULL;
 	info.key_offset = offsetof(struct dhash_entry, ptr);
 	ohash_init(&dhash_table, 18, &info);
+	info.key_offset = offsetof(struct dsite_entry, file);
+	ohash_init(&dsite_table, 10, &info);
 
 	dhash_fp = stderr;
 	if ((dhash_fn = getenv("DEBUG_MEMORY")) == NULL)
@@ -209,6 +237,9 @@ mandoc_dbg_init(int argc, char *argv[])
 		case 'A':
 			dhash_aflag = 1;
 			continue;
+		case 'C':
+			dhash_cflag = 1;
+			continue;
 		case 'F':
 			dhash_fflag = 1;
 			continue;
@@ -218,6 +249,9 @@ mandoc_dbg_init(int argc, char *argv[])
 		case 'N':
 			dhash_nflag = 1;
 			continue;
+		case 'R':
+			dhash_rflag = 1;
+			continue;
 		case '/':
 			if ((dhash_fp = fopen(dhash_fn, "a+e")) == NULL)
 				err((int)MANDOCLEVEL_SYSERR, "%s", dhash_fn);
@@ -291,6 +325,11 @@ dhash_register(const char *file, int line, const char *func,
 	e->ptr  = ptr;
 
 	ohash_insert(&dhash_table, slot, e);
+
+	if ((dhash_live += num * size) > dhash_peak)
+		dhash_peak = dhash_live;
+	if (dhash_cflag || dhash_rflag)
+		dsite_register(file, line, func, num * size);
 }
 
 /* Remove one allocation from the debugging table. */
@@ -307,10 +346,119 @@ dhash_purge(const char *file, int line, const char *func, void *ptr)
 		fprintf(dhash_fp, "F %s:%d %s(%p)\n", file, line, func, ptr);
 
 	slot = dhash_slot(ptr);
-	e = ohash_remove(&dhash_table, slot);
+	if ((e = ohash_remove(&dhash_table, slot)) != NULL)
+		dhash_live -= e->num * e->size;
 	free(e);
 }
 
+/* Add one allocation to the profile of its call site. */
+static void
+dsite_register(const char *file, int line, const char *func, size_t sz)
+{
+	struct dsite_entry	 key, *e;
+	const char		*ks, *ke;
+	enum mandoc_stage	 stage;
+	unsigned int		 slot;
+	size_t			 class;
+
+	key.file = file;
+	key.line = line;
+	ks = (const char *)&key.file;
+	ke = (const char *)(&key.line + 1);
+	slot = ohash_lookup_memory(&dsite_table, ks, ke - ks,
+	    ohash_interval(ks, &ke));
+	if ((e = ohash_find(&dsite_table, slot)) == NULL) {
+		if ((e = calloc(1, sizeof(*e))) == NULL)
+			err(1, NULL);
+		e->file = file;
+		e->line = line;
+		e->func = func;
+		ohash_insert(&dsite_table, slot, e);
+	}
+	stage = mandoc_stats_current();
+	e->count[stage]++;
+	e->bytes[stage] += sz;
+	e->total += sz;
+
+	for (class = 0; class + 1 < DHIST_MAX &&
+	    sz > (size_t)1 << class; class++)
+		continue;
+	dhist_count[class]++;
+	dhist_bytes[class] += sz;
+}
+
+/* Sort call sites by decreasing number of bytes allocated. */
+static int
+dsite_cmp(const void *a, const void *b)
+{
+	const struct dsite_entry *ea, *eb;
+
+	ea = *(const struct dsite_entry *const *)a;
+	eb = *(const struct dsite_entry *const *)b;
+	if (ea->total != eb->total)
+		return ea->total < eb->total ? 1 : -1;
+	if (ea->line != eb->line)
+		return ea->line - eb->line;
+	return strcmp(ea->file, eb->file);
+}
+
+/* Print the allocation profile and free the call site table. */
+static void
+dsite_report(void)
+{
+	struct dsite_entry	**sites, *e;
+	size_t			  count[MSTAGE_MAX], bytes[MSTAGE_MAX];
+	size_t			  ccount, i, nsites;
+	unsigned int		  slot;
+	int			  stage;
+
+	nsites = ohash_entries(&dsite_table);
+	if ((sites = calloc(nsites + 1, sizeof(*sites))) == NULL)
+		err(1, NULL);
+	i = 0;
+	for (e = ohash_first(&dsite_table, &slot); e != NULL;
+	     e = ohash_next(&dsite_table, &slot))
+		sites[i++] = e;
+	qsort(sites, nsites, sizeof(*sites), dsite_cmp);
+
+	memset(count, 0, sizeof(count));
+	memset(bytes, 0, sizeof(bytes));
+	for (i = 0; i < nsites; i++) {
+		e = sites[i];
+		ccount = 0;
+		for (stage = 0; stage < MSTAGE_MAX; stage++) {
+			ccount += e->count[stage];
+			count[stage] += e->count[stage];
+			bytes[stage] += e->bytes[stage];
+			if (dhash_cflag && e->bytes[stage] > 0)
+				fprintf(dhash_fp, "C %s;%s:%d;%s %zu\n",
+				    mandoc_stats_name(stage),
+				    e->file, e->line, e->func,
+				    e->bytes[stage]);
+		}
+		if (dhash_rflag)
+			fprintf(dhash_fp, "R %zu %zu %s:%d %s\n",
+			    e->total, ccount, e->file, e->line, e->func);
+		free(e);
+	}
+	free(sites);
+	ohash_delete(&dsite_table);
+	if (dhash_rflag == 0)
+		return;
+
+	for (stage = 0; stage < MSTAGE_MAX; stage++)
+		if (count[stage] > 0)
+			fprintf(dhash_fp, "T %s %zu %zu\n",
+			    mandoc_stats_name(stage),
+			    bytes[stage], count[stage]);
+	for (i = 0; i < DHIST_MAX; i++)
+		if (dhist_count[i] > 0)
+			fprintf(dhash_fp, "H %zu %zu %zu\n",
+			    i + 1 < DHIST_MAX ? (size_t)1 << i : SIZE_MAX,
+			    dhist_bytes[i], dhist_count[i]);
+	fprintf(dhash_fp, "M %zu peak bytes in use\n", dhash_peak);
+}
+
 /* Pretty-print information about one allocation. */
 static void
 dhash_print(struct dhash_entry *e)
@@ -326,6 +474,7 @@ mandoc_dbg_finish(void)
 	struct dhash_entry	*e;
 	unsigned int		 errcount, slot;
 
+	dsite_report();
 	errcount = ohash_entries(&dhash_table);
 	e = ohash_first(&dhash_table, &slot);
 	while (e != NULL) {
@@ -19,12 +19,31 @@
  */
 #include "config.h"
 
+#if HAVE_ERR
+#include <err.h>
+#endif
 #include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "mandoc_aux.h"
+#include "mandoc_ohash.h"
 #include "mandoc.h"
 
+/* One distinct message buffered for collapsing. */
+struct	msgent {
+	const char	*arg;	/* Argument, pointing into key, or NULL. */
+	char		*file;	/* Input file of the first occurrence. */
+	enum mandocerr	 type;
+	int		 line;	/* Of the first occurrence. */
+	int		 col;
+	unsigned int	 count;	/* Number of occurrences. */
+	char		 key[];	/* Type, file name, and argument. */
+};
+
 static	const enum mandocerr lowest_type[MANDOCLEVEL_MAX] = {
 	MANDOCERR_OK,
 	MANDOCERR_OK,
@@ -203,6 +222,7 @@ static	const char *const type_message[MANDOCERR_MAX] = {
 	"duplicate prologue macro",
 	"skipping late title macro",
 	"input stack limit exceeded, infinite loop?",
+	"parse budget exceeded, stopping",
 	"skipping bad character",
 	"skipping unknown macro",
 	"ignoring request outside macro",
@@ -284,6 +304,7 @@ static	const char *const type_message[MANDOCERR_MAX] = {
 	"mkstemp",
 	"open",
 	"PATH",
+	"pipe",
 	"pledge",
 	"read",
 	"unveil",
@@ -295,6 +316,21 @@ static	FILE		*fileptr = NULL;
 static	const char	*filename = NULL;
 static	enum mandocerr	 min_type = MANDOCERR_BADARG;
 static	enum mandoclevel rc = MANDOCLEVEL_OK;
+static	mandoc_msg_handler handler = NULL;
+static	void		*handler_arg = NULL;
+static	int		 collapse = 0;
+static	struct ohash	 msgtab;	/* Buffered messages by key. */
+static	struct msgent	**msgbuf;	/* Buffered messages in order. */
+static	size_t		 msgbufsz;	/* Number of buffered messages. */
+static	size_t		 msgbufmax;	/* Allocated size of msgbuf. */
+
+static	enum mandoclevel msg_level(enum mandocerr);
+static	void		 msg_emit(enum mandoclevel, enum mandocerr,
+				const char *, int, int, const char *,
+				unsigned int);
+static	void		 msg_prefix(enum mandoclevel, enum mandocerr,
+				const char *, int, int);
+static	void		 msg_save(enum mandocerr, int, int, const char *);
 
 
 void
@@ -303,6 +339,29 @@ mandoc_msg_setoutfile(FILE *fp)
 	fileptr = fp;
 }
 
+/*
+ * Pass messages to the function hf instead of printing them,
+ * or print them again if hf is NULL.
+ */
+void
+mandoc_msg_sethandler(mandoc_msg_handler hf, void *arg)
+{
+	handler = hf;
+	handler_arg = arg;
+}
+
+/*
+ * If on is non-zero, buffer messages about input files until
+ * mandoc_msg_flush() is called, reporting repeated messages
+ * of the same type with the same argument in the same file only once.
+ */
+void
+mandoc_msg_setcollapse(int on)
+{
+	mandoc_msg_flush();
+	collapse = on;
+}
+
 const char *
 mandoc_msg_getinfilename(void)
 {
@@ -340,26 +399,158 @@ mandoc_msg_setrc(enum mandoclevel level)
 		rc = level;
 }
 
+static enum mandoclevel
+msg_level(enum mandocerr t)
+{
+	enum mandoclevel	 level;
+
+	level = MANDOCLEVEL_SYSERR;
+	while (t < lowest_type[level])
+		level--;
+	return level;
+}
+
 void
 mandoc_msg(enum mandocerr t, int line, int col, const char *fmt, ...)
 {
 	va_list			 ap;
+	char			*arg;
 	enum mandoclevel	 level;
 
 	if (t < min_type)
 		return;
 
-	level = MANDOCLEVEL_SYSERR;
-	while (t < lowest_type[level])
-		level--;
+	level = msg_level(t);
 	mandoc_msg_setrc(level);
 
+	if (fileptr == NULL && handler == NULL)
+		return;
+
+	/* Fast path: print the message right away. */
+
+	if (handler == NULL && (collapse == 0 || filename == NULL)) {
+		msg_prefix(level, t, filename, line, col);
+		if (fmt != NULL) {
+			fprintf(fileptr, ": ");
+			va_start(ap, fmt);
+			vfprintf(fileptr, fmt, ap);
+			va_end(ap);
+		}
+		fputc('\n', fileptr);
+		return;
+	}
+
+	arg = NULL;
+	if (fmt != NULL) {
+		va_start(ap, fmt);
+		if (vasprintf(&arg, fmt, ap) == -1)
+			err((int)MANDOCLEVEL_SYSERR, NULL);
+		va_end(ap);
+	}
+	if (collapse && filename != NULL)
+		msg_save(t, line, col, arg);
+	else
+		msg_emit(level, t, filename, line, col, arg, 1);
+	free(arg);
+}
+
+/*
+ * Buffer one message, or count it if the same type with the same
+ * argument is already buffered for the same file.  The length of
+ * the file name is part of the key, such that it cannot be confused
+ * with the argument.
+ */
+static void
+msg_save(enum mandocerr t, int line, int col, const char *arg)
+{
+	struct msgent	*ent;
+	char		*key;
+	size_t		 sz;
+	unsigned int	 slot;
+
+	if (msgbufmax == 0)
+		mandoc_ohash_init(&msgtab, 6, offsetof(struct msgent, key));
+	if (arg == NULL)
+		sz = mandoc_asprintf(&key, "%d %zu %s",
+		    t, strlen(filename), filename);
+	else
+		sz = mandoc_asprintf(&key, "%d %zu %s %s",
+		    t, strlen(filename), filename, arg);
+	slot = ohash_qlookup(&msgtab, key);
+	if ((ent = ohash_find(&msgtab, slot)) != NULL) {
+		ent->count++;
+		free(key);
+		return;
+	}
+	ent = mandoc_malloc(sizeof(*ent) + sz + 1);
+	memcpy(ent->key, key, sz + 1);
+	free(key);
+	ent->arg = arg == NULL ? NULL : ent->key + sz - strlen(arg);
+	ent->file = mandoc_strdup(filename);
+	ent->type = t;
+	ent->line = line;
+	ent->col = col;
+	ent->count = 1;
+	ohash_insert(&msgtab, slot, ent);
+	if (msgbufsz == msgbufmax) {
+		msgbufmax += 64;
+		msgbuf = mandoc_reallocarray(msgbuf,
+		    msgbufmax, sizeof(*msgbuf));
+	}
+	msgbuf[msgbufsz++] = ent;
+}
+
+/*
+ * Report all buffered messages in the order of their first
+ * occurrence, then forget them.
+ */
+void
+mandoc_msg_flush(void)
+{
+	struct msgent	*ent;
+	size_t		 i;
+
+	if (msgbufmax == 0)
+		return;
+	for (i = 0; i < msgbufsz; i++) {
+		ent = msgbuf[i];
+		msg_emit(msg_level(ent->type), ent->type, ent->file,
+		    ent->line, ent->col, ent->arg, ent->count);
+		free(ent->file);
+		free(ent);
+	}
+	ohash_delete(&msgtab);
+	free(msgbuf);
+	msgbuf = NULL;
+	msgbufsz = msgbufmax = 0;
+}
+
+static void
+msg_emit(enum mandoclevel level, enum mandocerr t, const char *fn,
+    int line, int col, const char *arg, unsigned int count)
+{
+	if (handler != NULL) {
+		(*handler)(handler_arg, level, t, fn, line, col, arg, count);
+		return;
+	}
 	if (fileptr == NULL)
 		return;
+	msg_prefix(level, t, fn, line, col);
+	if (arg != NULL)
+		fprintf(fileptr, ": %s", arg);
+	if (count > 1)
+		fprintf(fileptr, " (%u times)", count);
+	fputc('\n', fileptr);
+}
 
+/* Print the message without argument and without newline. */
+static void
+msg_prefix(enum mandoclevel level, enum mandocerr t, const char *fn,
+    int line, int col)
+{
 	fprintf(fileptr, "%s:", getprogname());
-	if (filename != NULL)
-		fprintf(fileptr, " %s:", filename);
+	if (fn != NULL)
+		fprintf(fileptr, " %s:", fn);
 
 	if (line > 0)
 		fprintf(fileptr, "%d:%d:", line, col + 1);
@@ -367,21 +558,19 @@ mandoc_msg(enum mandocerr t, int line, int col, const char *fmt, ...)
 	fprintf(fileptr, " %s", level_name[level]);
 	if (type_message[t] != NULL)
 		fprintf(fileptr, ": %s", type_message[t]);
-
-	if (fmt != NULL) {
-		fprintf(fileptr, ": ");
-		va_start(ap, fmt);
-		vfprintf(fileptr, fmt, ap);
-		va_end(ap);
-	}
-	fputc('\n', fileptr);
 }
 
+/*
+ * If the output was printed while parsing was still in progress,
+ * messages may be interleaved with the output.
+ */
 void
-mandoc_msg_summary(void)
+mandoc_msg_summary(int interleaved)
 {
+	mandoc_msg_flush();
 	if (fileptr != NULL && rc != MANDOCLEVEL_OK)
 		fprintf(fileptr,
-		    "%s: see above the output for %s messages\n",
-		    getprogname(), level_name[rc]);
+		    "%s: see %s the output for %s messages\n",
+		    getprogname(), interleaved ? "above and inside" : "above",
+		    level_name[rc]);
 }
@@ -30,15 +30,36 @@
 #define	MPARSE_LATIN1	(1 << 5)  /* accept ISO-LATIN-1 input */
 #define	MPARSE_VALIDATE	(1 << 6)  /* call validation functions */
 #define	MPARSE_COMMENT	(1 << 7)  /* save comments in the tree */
+#define	MPARSE_ESCAPES	(1 << 8)  /* decode escapes in text nodes */
 
 
 struct	roff_meta;
+struct	roff_node;
 struct	mparse;
 
+/*
+ * Limits on the work done for one document, 0 for no limit.
+ * When one is exceeded, parsing stops and the partial
+ * syntax tree is validated and returned as usual.
+ */
+struct	mparse_budget {
+	unsigned long	  cpu; /* CPU time in milliseconds */
+	unsigned long	  bytes; /* input bytes after roff(7) expansion */
+	unsigned long	  nodes; /* syntax tree nodes allocated */
+	unsigned long	  memory; /* growth of peak memory usage in kB */
+};
+
+typedef	void	(*mparse_part)(void *, const struct roff_meta *,
+			struct roff_node *);
+
 struct mparse	 *mparse_alloc(int, enum mandoc_os, const char *);
+void		  mparse_budget(struct mparse *, const struct mparse_budget *);
+int		  mparse_budget_arg(struct mparse_budget *, const char *);
 void		  mparse_copy(const struct mparse *);
 void		  mparse_free(struct mparse *);
 int		  mparse_open(struct mparse *, const char *);
 void		  mparse_readfd(struct mparse *, int, const char *);
 void		  mparse_reset(struct mparse *);
 struct roff_meta *mparse_result(struct mparse *);
+void		  mparse_sections(struct mparse *, unsigned int);
+void		  mparse_stream(struct mparse *, mparse_part, void *);
@@ -0,0 +1,183 @@
+/* $Id$ */
+/*
+ * Copyright (c) 2026 The mandoc developers <tech@mandoc.bsd.lv>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * Optional statistics about the time spent in the various stages
+ * of parsing and formatting and about the amount of work done.
+ */
+#include "config.h"
+
+#include <sys/types.h>
+#include <sys/resource.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "mandoc.h"
+
+static	const char *const stage_name[MSTAGE_MAX] = {
+	"other",
+	"read",
+	"line",
+	"roff",
+	"macro",
+	"validate",
+	"post",
+	"format"
+};
+
+static	const char *const count_name[MCOUNT_MAX] = {
+	"files",
+	"bytes",
+	"lines",
+	"nodes",
+	"escapes",
+	"macros",
+	"allocs"
+};
+
+static	FILE		 *stats_fp;	/* NULL if statistics are off. */
+static	struct timespec	  stats_last;	/* Start of the current stage. */
+static	enum mandoc_stage stats_stage;	/* Stage currently running. */
+static	long long	  stats_nsec[MSTAGE_MAX];
+static	unsigned long long stats_count[MCOUNT_MAX];
+
+
+/*
+ * Start collecting statistics if the MANDOC_STATS environment
+ * variable is set.  The report is appended to the file named
+ * by its value, or written to standard error if it is empty.
+ */
+void
+mandoc_stats_init(void)
+{
+	const char	*fn;
+	FILE		*fp;
+
+	if ((fn = getenv("MANDOC_STATS")) == NULL)
+		return;
+	if (*fn == '\0')
+		fp = stderr;
+	else if ((fp = fopen(fn, "ae")) == NULL) {
+		perror(fn);
+		return;
+	}
+	mandoc_stats_start(fp);
+}
+
+/*
+ * Start collecting statistics, to be reported to fp
+ * by mandoc_stats_finish().
+ */
+void
+mandoc_stats_start(FILE *fp)
+{
+	stats_fp = fp;
+	stats_stage = MSTAGE_NONE;
+	clock_gettime(CLOCK_MONOTONIC, &stats_last);
+}
+
+/*
+ * Charge the time since the previous call to the stage then running,
+ * switch to the new stage, and return the previous one such that the
+ * caller can restore it when done.
+ */
+enum mandoc_stage
+mandoc_stats_stage(enum mandoc_stage stage)
+{
+	struct timespec		 now;
+	enum mandoc_stage	 prev;
+
+	prev = stats_stage;
+	stats_stage = stage;
+	if (stats_fp == NULL)
+		return prev;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	stats_nsec[prev] +=
+	    (long long)(now.tv_sec - stats_last.tv_sec) * 1000000000LL +
+	    (now.tv_nsec - stats_last.tv_nsec);
+	stats_last = now;
+	return prev;
+}
+
+/*
+ * The stage is tracked even when statistics are off,
+ * such that mandoc_dbg.c can attribute allocations to it.
+ */
+enum mandoc_stage
+mandoc_stats_current(void)
+{
+	return stats_stage;
+}
+
+const char *
+mandoc_stats_name(enum mandoc_stage stage)
+{
+	return stage_name[stage];
+}
+
+void
+mandoc_stats_count(enum mandoc_count counter, size_t amount)
+{
+	if (stats_fp != NULL)
+		stats_count[counter] += amount;
+}
+
+/*
+ * Return the peak resident set size in kilobytes.
+ * Darwin reports ru_maxrss in bytes, other systems in kilobytes.
+ */
+long
+mandoc_stats_maxrss(const struct rusage *ru)
+{
+#ifdef __APPLE__
+	return ru->ru_maxrss / 1024;
+#else
+	return ru->ru_maxrss;
+#endif
+}
+
+/*
+ * Print the report, one item per line, and stop collecting:
+ * P pid progname
+ * T stage microseconds
+ * C counter value
+ * R maxrss kilobytes
+ */
+void
+mandoc_stats_finish(void)
+{
+	struct rusage	 ru;
+	int		 i;
+
+	if (stats_fp == NULL)
+		return;
+	mandoc_stats_stage(MSTAGE_NONE);
+	fprintf(stats_fp, "P %ld %s\n", (long)getpid(), getprogname());
+	for (i = 0; i < MSTAGE_MAX; i++)
+		fprintf(stats_fp, "T %s %lld\n",
+		    stage_name[i], stats_nsec[i] / 1000);
+	for (i = 0; i < MCOUNT_MAX; i++)
+		fprintf(stats_fp, "C %s %llu\n",
+		    count_name[i], stats_count[i]);
+	if (getrusage(RUSAGE_SELF, &ru) == 0)
+		fprintf(stats_fp, "R maxrss %ld\n", mandoc_stats_maxrss(&ru));
+	fflush(stats_fp);
+	if (stats_fp != stderr)
+		fclose(stats_fp);
+	stats_fp = NULL;
+}
@@ -56,6 +56,7 @@ enum	outt {
 };
 
 static	void	  process(struct mparse *, enum outt, void *);
+static	void	  put_page(const char *, size_t);
 static	int	  read_fds(int, int *);
 static	void	  usage(void) __attribute__((__noreturn__));
 
@@ -135,6 +136,7 @@ main(int argc, char *argv[])
 {
 	struct sigaction	 sa;
 	struct manoutput	 options;
+	struct mparse_budget	 budget;
 	struct mparse		*parser;
 	void			*formatter;
 	const char		*defos;
@@ -150,15 +152,17 @@ main(int argc, char *argv[])
 #if DEBUG_MEMORY
 	mandoc_dbg_init(argc, argv);
 #endif
+	mandoc_stats_init();
 
 	defos = NULL;
+	memset(&budget, 0, sizeof(budget));
 	outtype = OUTT_ASCII;
 	while ((opt = getopt(argc, argv, "I:T:")) != -1) {
 		switch (opt) {
 		case 'I':
 			if (strncmp(optarg, "os=", 3) == 0)
 				defos = optarg + 3;
-			else {
+			else if (mparse_budget_arg(&budget, optarg) == -1) {
 				warnx("-I %s: Bad argument", optarg);
 				usage();
 			}
@@ -207,6 +211,7 @@ main(int argc, char *argv[])
 	mchars_alloc();
 	parser = mparse_alloc(MPARSE_SO | MPARSE_UTF8 | MPARSE_LATIN1 |
 	    MPARSE_VALIDATE, MANDOC_OS_OTHER, defos);
+	mparse_budget(parser, &budget);
 
 	memset(&options, 0, sizeof(options));
 	switch (outtype) {
@@ -274,6 +279,7 @@ main(int argc, char *argv[])
 	}
 	mparse_free(parser);
 	mchars_free();
+	mandoc_stats_finish();
 #if DEBUG_MEMORY
 	mandoc_dbg_finish();
 #endif
@@ -284,9 +290,22 @@ static void
 process(struct mparse *parser, enum outt outtype, void *formatter)
 {
 	struct roff_meta *meta;
+	char		 *page;
+	size_t		  pagesz;
 
 	mparse_readfd(parser, STDIN_FILENO, "<unixfd>");
 	meta = mparse_result(parser);
+	mandoc_stats_stage(MSTAGE_FORMAT);
+
+	/*
+	 * Collect terminal output in memory
+	 * and pass the complete page on at once.
+	 */
+
+	page = NULL;
+	pagesz = 0;
+	if (outtype != OUTT_HTML)
+		ascii_setmem(formatter, &page, &pagesz);
 	if (meta->macroset == MACROSET_MDOC) {
 		switch (outtype) {
 		case OUTT_ASCII:
@@ -309,11 +328,35 @@ process(struct mparse *parser, enum outt outtype, void *formatter)
 			break;
 		}
 	}
+	if (outtype != OUTT_HTML) {
+		ascii_setmem(formatter, NULL, NULL);
+		put_page(page, pagesz);
+		free(page);
+	}
+	mandoc_stats_stage(MSTAGE_NONE);
+}
+
+static void
+put_page(const char *page, size_t sz)
+{
+	ssize_t	 wsz;
+
+	while (sz > 0) {
+		if ((wsz = write(STDOUT_FILENO, page, sz)) == -1) {
+			if (errno == EINTR)
+				continue;
+			warn("write");
+			return;
+		}
+		page += wsz;
+		sz -= wsz;
+	}
 }
 
 void
 usage(void)
 {
-	fprintf(stderr, "usage: mandocd [-I os=name] [-T output] socket_fd\n");
+	fprintf(stderr, "usage: mandocd [-I os=name] [-I budget=limit] "
+	    "[-T output] socket_fd\n");
 	exit(1);
 }
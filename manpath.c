@@ -266,7 +266,7 @@ manconf_output(struct manoutput *conf, const char *cp, int fromfile)
 	    /* Token taking an optional argument. */
 	    "tag",
 	    /* Tokens not taking arguments. */
-	    "fragment", "noval", "toc"
+	    "fragment", "noval", "toc", "pipe", "stream"
 	};
 	const size_t ntoks = sizeof(toks) / sizeof(toks[0]);
 
@@ -381,6 +381,12 @@ manconf_output(struct manoutput *conf, const char *cp, int fromfile)
 	case 11:
 		conf->toc = 1;
 		return 0;
+	case 12:
+		conf->pipe = 1;
+		return 0;
+	case 13:
+		conf->stream = 1;
+		return 0;
 	default:
 		mandoc_msg(MANDOCERR_BADARG_BAD, 0, 0, "-O %s", cp);
 		return -1;
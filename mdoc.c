@@ -239,7 +239,7 @@ mdoc_ptext(struct roff_man *mdoc, int line, char *buf, int offs)
 	if (buf[offs] == '\0' && (mdoc->flags & ROFF_NOFILL) == 0) {
 		switch (mdoc->last->type) {
 		case ROFFT_TEXT:
-			sp = mdoc->last->string;
+			sp = roff_word_own(mdoc->last);
 			cp = end = strchr(sp, '\0') - 2;
 			if (cp < sp || cp[0] != '\\' || cp[1] != 'c')
 				break;
@@ -156,3 +156,4 @@ union	mdoc_data {
 extern	const char *const *mdoc_argnames;
 
 void		 mdoc_validate(struct roff_man *);
+void		 mdoc_validate_root(struct roff_man *);
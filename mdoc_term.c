@@ -59,6 +59,8 @@ static	int	  a2width(const struct termp *, const char *);
 
 static	void	  print_bvspace(struct termp *,
 			struct roff_node *, struct roff_node *);
+static	struct roff_node *print_mdoc_begin(struct termp *,
+			const struct roff_meta *);
 static	void	  print_mdoc_node(DECL_ARGS);
 static	void	  print_mdoc_nodelist(DECL_ARGS);
 static	void	  print_mdoc_head(struct termp *, const struct roff_meta *);
@@ -253,12 +255,18 @@ terminal_mdoc(void *arg, const struct roff_meta *mdoc)
 	struct termp		*p;
 
 	p = (struct termp *)arg;
-	p->tcol->rmargin = p->maxrmargin = p->defrmargin;
-	term_tab_set(p, NULL);
-	term_tab_set(p, "T");
-	term_tab_set(p, ".5i");
 
-	n = mdoc->first->child;
+	/* Finish a document that was partly printed while parsing. */
+
+	if (p->lastpart != NULL) {
+		print_mdoc_nodelist(p, NULL, mdoc, p->lastpart->next);
+		p->lastpart = NULL;
+		term_end(p);
+		term_tag_flush();
+		return;
+	}
+
+	n = print_mdoc_begin(p, mdoc);
 	if (p->synopsisonly) {
 		for (nn = NULL; n != NULL; n = n->next) {
 			if (n->tok != MDOC_Sh)
@@ -275,18 +283,77 @@ terminal_mdoc(void *arg, const struct roff_meta *mdoc)
 			print_mdoc_nodelist(p, NULL, mdoc, n);
 		term_newln(p);
 	} else {
-		term_begin(p, print_mdoc_head, print_mdoc_foot, mdoc);
-		while (n != NULL &&
-		    (n->type == ROFFT_COMMENT ||
-		     n->flags & NODE_NOPRT))
-			n = n->next;
-		if (n != NULL) {
-			if (n->tok != MDOC_Sh)
-				term_vspace(p);
+		if (n != NULL)
 			print_mdoc_nodelist(p, NULL, mdoc, n);
-		}
 		term_end(p);
 	}
+	term_tag_flush();
+}
+
+/*
+ * Print the top level nodes up to and including the node last
+ * while the rest of the document is still being parsed.
+ * The page header is only printed once the prologue is known;
+ * until then, do nothing, return 0, and let terminal_mdoc() start over.
+ */
+int
+terminal_mdoc_part(void *arg, const struct roff_meta *mdoc,
+    struct roff_node *last)
+{
+	struct roff_node	*n;
+	struct termp		*p;
+
+	p = (struct termp *)arg;
+	if (p->lastpart == NULL) {
+		if (p->synopsisonly ||
+		    mdoc->title == NULL || mdoc->vol == NULL)
+			return 0;
+		for (n = mdoc->first->child;
+		     n->type == ROFFT_COMMENT || n->flags & NODE_NOPRT;
+		     n = n->next)
+			if (n == last)
+				return 0;
+		n = print_mdoc_begin(p, mdoc);
+	} else
+		n = p->lastpart->next;
+
+	for (;;) {
+		print_mdoc_node(p, NULL, mdoc, n);
+		if (n == last)
+			break;
+		n = n->next;
+	}
+	p->lastpart = last;
+	return 1;
+}
+
+/*
+ * Set up margins and tab stops for a new document and, unless
+ * only the synopsis is wanted, print the page header.
+ * Return the first top level node to print.
+ */
+static struct roff_node *
+print_mdoc_begin(struct termp *p, const struct roff_meta *mdoc)
+{
+	struct roff_node	*n;
+
+	p->tcol->rmargin = p->maxrmargin = p->defrmargin;
+	term_tab_set(p, NULL);
+	term_tab_set(p, "T");
+	term_tab_set(p, ".5i");
+
+	n = mdoc->first->child;
+	if (p->synopsisonly)
+		return n;
+
+	term_begin(p, print_mdoc_head, print_mdoc_foot, mdoc);
+	while (n != NULL &&
+	    (n->type == ROFFT_COMMENT ||
+	     n->flags & NODE_NOPRT))
+		n = n->next;
+	if (n != NULL && n->tok != MDOC_Sh)
+		term_vspace(p);
+	return n;
 }
 
 static void
@@ -374,7 +441,7 @@ print_mdoc_node(DECL_ARGS)
 		}
 		if (NODE_DELIMC & n->flags)
 			p->flags |= TERMP_NOSPACE;
-		term_word(p, n->string);
+		term_word_esc(p, n->string, n->esc);
 		if (NODE_DELIMO & n->flags)
 			p->flags |= TERMP_NOSPACE;
 		break;
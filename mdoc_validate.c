@@ -393,6 +393,18 @@ mdoc_validate(struct roff_man *mdoc)
 	}
 }
 
+/*
+ * Validate the root node only, for use when all its children
+ * were already validated one by one.
+ */
+void
+mdoc_validate_root(struct roff_man *mdoc)
+{
+	mdoc->last = mdoc->meta.first;
+	mdoc->next = ROFF_NEXT_SIBLING;
+	post_root(mdoc);
+}
+
 static void
 check_args(struct roff_man *mdoc, struct roff_node *n)
 {
@@ -1011,8 +1023,10 @@ post_lb(POST_ARGS)
 			mdoc->last = nch;
 			assert(nch->type == ROFFT_TEXT);
 			cp = nch->string;
- 			if (strncmp(cp, "lib", 3) == 0)
+ 			if (strncmp(cp, "lib", 3) == 0) {
+				cp = roff_word_own(nch);
 				memmove(cp, cp + 3, strlen(cp) - 3 + 1);
+			}
 			nch = nch->next;
 		}
 		roff_word_alloc(mdoc, n->line, n->pos, "*/");
@@ -1666,7 +1680,7 @@ post_fl(POST_ARGS)
 	    n->prev->child == NULL && n->child != NULL &&
 	    (n->flags & NODE_LINE) == 0) {
 		mandoc_asprintf(&cp, "\\-%s", n->child->string);
-		free(n->child->string);
+		free(roff_word_own(n->child));
 		n->child->string = cp;
 		roff_node_delete(mdoc, n->prev);
 	}
@@ -1705,7 +1719,7 @@ post_xx(POST_ARGS)
 		n->child->flags |= NODE_NOPRT;
 		mdoc->next = ROFF_NEXT_CHILD;
 		roff_word_alloc(mdoc, n->child->line, n->child->pos, v);
-		v = mdoc->last->string;
+		v = roff_word_own(mdoc->last);
 		v[3] = toupper((unsigned char)v[3]);
 		mdoc->last->flags |= NODE_NOSRC;
 		mdoc->last = n;
@@ -1918,10 +1932,10 @@ post_bl_head(POST_ARGS)
 	nh->norm->Bl.cols = (void *)argv->value;
 
 	for (nch = nh->child; nch != NULL; nch = nnext) {
-		argv->value[i++] = nch->string;
+		argv->value[i++] = roff_word_own(nch);
 		nch->string = NULL;
 		nnext = nch->next;
-		roff_node_delete(NULL, nch);
+		roff_node_delete(mdoc, nch);
 	}
 	nh->child = NULL;
 }
@@ -2246,6 +2260,7 @@ post_hyph(POST_ARGS)
 {
 	struct roff_node	*n, *nch;
 	char			*cp;
+	size_t			 off;
 
 	n = mdoc->last;
 	for (nch = n->child; nch != NULL; nch = nch->next) {
@@ -2260,6 +2275,8 @@ post_hyph(POST_ARGS)
 			    isalpha((unsigned char)cp[1])) {
 				if (n->tag == NULL && n->flags & NODE_ID)
 					n->tag = mandoc_strdup(nch->string);
+				off = cp - nch->string;
+				cp = roff_word_own(nch) + off;
 				*cp = ASCII_HYPH;
 			}
 	}
@@ -2823,7 +2840,7 @@ post_dt(POST_ARGS)
 	if ((nn = nn->next) == NULL)
 		return;
 
-	for (p = nn->string; *p != '\0'; p++)
+	for (p = roff_word_own(nn); *p != '\0'; p++)
 		*p = tolower((unsigned char)*p);
 	mdoc->meta.arch = mandoc_strdup(nn->string);
 
@@ -2839,6 +2856,7 @@ post_bx(POST_ARGS)
 {
 	struct roff_node	*n, *nch;
 	const char		*macro;
+	char			*cp;
 
 	post_delim_nb(mdoc);
 
@@ -2884,7 +2902,10 @@ post_bx(POST_ARGS)
 	 * uppercase blindly.
 	 */
 
-	*nch->string = (char)toupper((unsigned char)*nch->string);
+	if (islower((unsigned char)*nch->string)) {
+		cp = roff_word_own(nch);
+		*cp = (char)toupper((unsigned char)*cp);
+	}
 }
 
 static void
@@ -21,7 +21,6 @@
 #include <sys/types.h>
 
 #include <assert.h>
-#include <ctype.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -41,12 +40,11 @@ struct	tbl_colgroup {
 };
 
 static	size_t	tblcalc_data(struct rofftbl *, struct roffcol *,
-			const struct tbl_opts *, const struct tbl_dat *,
-			size_t);
+			const struct tbl_dat *, size_t);
 static	size_t	tblcalc_literal(struct rofftbl *, struct roffcol *,
 			const struct tbl_dat *, size_t);
 static	size_t	tblcalc_number(struct rofftbl *, struct roffcol *,
-			const struct tbl_opts *, const struct tbl_dat *);
+			const struct tbl_dat *);
 
 
 /*
@@ -186,8 +184,7 @@ tblcalc(struct rofftbl *tbl, const struct tbl_span *sp_first,
 			 */
 
 			width = tblcalc_data(tbl,
-			    dp->hspans == 0 ? col : NULL,
-			    opts, dp,
+			    dp->hspans == 0 ? col : NULL, dp,
 			    dp->block == 0 ? 0 :
 			    dp->layout->width ? dp->layout->width :
 			    rmargin ? (rmargin / enw + sp->opts->cols / 2) /
@@ -426,7 +423,7 @@ tblcalc(struct rofftbl *tbl, const struct tbl_span *sp_first,
 
 static size_t
 tblcalc_data(struct rofftbl *tbl, struct roffcol *col,
-    const struct tbl_opts *opts, const struct tbl_dat *dp, size_t mw)
+    const struct tbl_dat *dp, size_t mw)
 {
 	size_t		 sz;
 
@@ -445,7 +442,7 @@ tblcalc_data(struct rofftbl *tbl, struct roffcol *col,
 	case TBL_CELL_RIGHT:
 		return tblcalc_literal(tbl, col, dp, mw);
 	case TBL_CELL_NUMBER:
-		return tblcalc_number(tbl, col, opts, dp);
+		return tblcalc_number(tbl, col, dp);
 	case TBL_CELL_DOWN:
 		return 0;
 	default:
@@ -496,9 +493,9 @@ tblcalc_literal(struct rofftbl *tbl, struct roffcol *col,
 
 static size_t
 tblcalc_number(struct rofftbl *tbl, struct roffcol *col,
-		const struct tbl_opts *opts, const struct tbl_dat *dp)
+		const struct tbl_dat *dp)
 {
-	const char	*cp, *lastdigit, *lastpoint;
+	const char	*cp, *lastpoint;
 	size_t		 totsz;	/* Total width of the number in basic units. */
 	size_t		 intsz; /* Width of the integer part in basic units. */
 	char		 buf[2];
@@ -511,27 +508,11 @@ tblcalc_number(struct rofftbl *tbl, struct roffcol *col,
 		return totsz;
 
 	/*
-	 * Find the last digit and
-	 * the last decimal point that is adjacent to a digit.
-	 * The alignment indicator "\&" overrides everything.
+	 * Not a number, treat as a literal string.
+	 * The parser already found the alignment point, if any.
 	 */
 
-	lastdigit = lastpoint = NULL;
-	for (cp = dp->string; cp[0] != '\0'; cp++) {
-		if (cp[0] == '\\' && cp[1] == '&') {
-			lastdigit = lastpoint = cp;
-			break;
-		} else if (cp[0] == opts->decimal &&
-		    (isdigit((unsigned char)cp[1]) ||
-		     (cp > dp->string && isdigit((unsigned char)cp[-1]))))
-			lastpoint = cp;
-		else if (isdigit((unsigned char)cp[0]))
-			lastdigit = cp;
-	}
-
-	/* Not a number, treat as a literal string. */
-
-	if (lastdigit == NULL) {
+	if (dp->align == -1) {
 		if (col != NULL && col->width < totsz)
 			col->width = totsz;
 		return totsz;
@@ -539,8 +520,7 @@ tblcalc_number(struct rofftbl *tbl, struct roffcol *col,
 
 	/* Measure the width of the integer part. */
 
-	if (lastpoint == NULL)
-		lastpoint = lastdigit + 1;
+	lastpoint = dp->string + dp->align;
 	intsz = 0;
 	buf[1] = '\0';
 	for (cp = dp->string; cp < lastpoint; cp++) {
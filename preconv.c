@@ -28,84 +28,121 @@
 #include "mandoc_parse.h"
 #include "libmandoc.h"
 
+static	void	 preconv_put(struct buf *, size_t *, unsigned int);
+
+/*
+ * Append the escape sequence for the Unicode code point cp,
+ * equivalent to printing it with "\\[u%.4X]".
+ */
+static void
+preconv_put(struct buf *ob, size_t *oi, unsigned int cp)
+{
+	static const char	 hex[] = "0123456789ABCDEF";
+	char			*p;
+	int			 shift;
+
+	p = ob->buf + *oi;
+	*p++ = '\\';
+	*p++ = '[';
+	*p++ = 'u';
+	shift = cp > 0xfffff ? 20 : cp > 0xffff ? 16 : 12;
+	for (; shift >= 0; shift -= 4)
+		*p++ = hex[(cp >> shift) & 0xf];
+	*p++ = ']';
+	*p = '\0';
+	*oi = p - ob->buf;
+}
+
+/*
+ * Encode the run of 8-bit characters starting at ib->buf[*ii]
+ * as long as ob has room for the worst case of 12 bytes,
+ * such that the caller only needs to handle the first byte
+ * that can neither be decoded as UTF-8 nor as ISO-LATIN-1.
+ */
 int
 preconv_encode(const struct buf *ib, size_t *ii, struct buf *ob, size_t *oi,
     int *filenc)
 {
 	const unsigned char	*cu;
-	int			 nby;
+	int			 done, nby;
 	unsigned int		 accum;
 
-	cu = (const unsigned char *)ib->buf + *ii;
-	assert(*cu & 0x80);
+	done = 0;
+	for (;;) {
+		cu = (const unsigned char *)ib->buf + *ii;
+		assert(*cu & 0x80);
 
-	if ( ! (*filenc & MPARSE_UTF8))
-		goto latin;
-
-	nby = 1;
-	while (nby < 5 && *cu & (1 << (7 - nby)))
-		nby++;
-
-	switch (nby) {
-	case 2:
-		accum = *cu & 0x1f;
-		if (accum < 0x02)  /* Obfuscated ASCII. */
+		if ( ! (*filenc & MPARSE_UTF8))
 			goto latin;
-		break;
-	case 3:
-		accum = *cu & 0x0f;
-		break;
-	case 4:
-		accum = *cu & 0x07;
-		if (accum > 0x04) /* Beyond Unicode. */
-			goto latin;
-		break;
-	default:  /* Bad sequence header. */
-		goto latin;
-	}
 
-	cu++;
-	switch (nby) {
-	case 3:
-		if ((accum == 0x00 && ! (*cu & 0x20)) ||  /* Use 2-byte. */
-		    (accum == 0x0d && *cu & 0x20))  /* Surrogates. */
-			goto latin;
-		break;
-	case 4:
-		if ((accum == 0x00 && ! (*cu & 0x30)) ||  /* Use 3-byte. */
-		    (accum == 0x04 && *cu & 0x30))  /* Beyond Unicode. */
-			goto latin;
-		break;
-	default:
-		break;
-	}
+		nby = 1;
+		while (nby < 5 && *cu & (1 << (7 - nby)))
+			nby++;
 
-	while (--nby) {
-		if ((*cu & 0xc0) != 0x80)  /* Invalid continuation. */
+		switch (nby) {
+		case 2:
+			accum = *cu & 0x1f;
+			if (accum < 0x02)  /* Obfuscated ASCII. */
+				goto latin;
+			break;
+		case 3:
+			accum = *cu & 0x0f;
+			break;
+		case 4:
+			accum = *cu & 0x07;
+			if (accum > 0x04) /* Beyond Unicode. */
+				goto latin;
+			break;
+		default:  /* Bad sequence header. */
 			goto latin;
-		accum <<= 6;
-		accum += *cu & 0x3f;
+		}
+
 		cu++;
-	}
+		switch (nby) {
+		case 3:
+			if ((accum == 0x00 && ! (*cu & 0x20)) ||  /* Use 2-byte. */
+			    (accum == 0x0d && *cu & 0x20))  /* Surrogates. */
+				goto latin;
+			break;
+		case 4:
+			if ((accum == 0x00 && ! (*cu & 0x30)) ||  /* Use 3-byte. */
+			    (accum == 0x04 && *cu & 0x30))  /* Beyond Unicode. */
+				goto latin;
+			break;
+		default:
+			break;
+		}
 
-	assert(accum > 0x7f);
-	assert(accum < 0x110000);
-	assert(accum < 0xd800 || accum > 0xdfff);
+		while (--nby) {
+			if ((*cu & 0xc0) != 0x80)  /* Invalid continuation. */
+				goto latin;
+			accum <<= 6;
+			accum += *cu & 0x3f;
+			cu++;
+		}
 
-	*oi += snprintf(ob->buf + *oi, 11, "\\[u%.4X]", accum);
-	*ii = (const char *)cu - ib->buf;
-	*filenc &= ~MPARSE_LATIN1;
-	return 1;
+		assert(accum > 0x7f);
+		assert(accum < 0x110000);
+		assert(accum < 0xd800 || accum > 0xdfff);
+
+		preconv_put(ob, oi, accum);
+		*ii = (const char *)cu - ib->buf;
+		*filenc &= ~MPARSE_LATIN1;
+		goto next;
 
 latin:
-	if ( ! (*filenc & MPARSE_LATIN1))
-		return 0;
+		if ( ! (*filenc & MPARSE_LATIN1))
+			return done;
 
-	*oi += snprintf(ob->buf + *oi, 11,
-	    "\\[u%.4X]", (unsigned char)ib->buf[(*ii)++]);
+		preconv_put(ob, oi, (unsigned char)ib->buf[(*ii)++]);
+		*filenc &= ~MPARSE_UTF8;
 
-	*filenc &= ~MPARSE_UTF8;
-	return 1;
+next:
+		done = 1;
+		if (*ii >= ib->sz || (ib->buf[*ii] & 0x80) == 0 ||
+		    *oi + 12 > ob->sz)
+			return 1;
+	}
 }
 
 int
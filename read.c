@@ -26,12 +26,14 @@
 
 #include <sys/types.h>
 #include <sys/mman.h>
+#include <sys/resource.h>
 #include <sys/stat.h>
 
 #include <assert.h>
 #include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -47,9 +49,37 @@
 #include "mandoc_parse.h"
 #include "libmandoc.h"
 #include "roff_int.h"
+#include "libmdoc.h"
 #include "tag.h"
 
 #define	REPARSE_LIMIT	1000
+#define	SOCACHE_BYTES	(4 * 1024 * 1024)
+#define	SOCACHE_FILES	256
+#define	BUDGET_WORK	64 /* lines between getrusage(2) calls */
+
+#if HAVE_STAT_MTIM
+#define	ST_MTIMENSEC(st)	((st)->st_mtim.tv_nsec)
+#else
+#define	ST_MTIMENSEC(st)	0L
+#endif
+
+/*
+ * Contents of a file included with .so, after decompression,
+ * kept for later documents including the same file.
+ */
+struct	socache {
+	struct socache	 *next; /* less recently used file */
+	char		 *buf; /* file contents */
+	size_t		  sz; /* length of buf */
+	dev_t		  dev; /* identity of the file ... */
+	ino_t		  ino;
+	time_t		  mtime; /* ... and of its version */
+	long		  mtimensec;
+	off_t		  size;
+	int		  gzip; /* file was decompressed */
+	int		  mapped; /* buf is mmap(2)ed, not malloc(3)ed */
+	int		  refs; /* being parsed, do not free */
+};
 
 struct	mparse {
 	struct roff	 *roff; /* roff parser (!NULL) */
@@ -57,7 +87,26 @@ struct	mparse {
 	struct buf	 *primary; /* buffer currently being parsed */
 	struct buf	 *secondary; /* copy of top level input */
 	struct buf	 *loop; /* open .while request line */
+	struct socache	 *socache; /* .so files, most recently used first */
+	struct mparse_budget budget; /* limits per document */
+	unsigned long	  budget_bytes; /* expanded bytes in this document */
+	unsigned long	  budget_nodes; /* node count at document start */
+	unsigned long	  budget_cpu; /* CPU time at document start [ms] */
+	long		  budget_rss; /* peak memory at document start [kB] */
+	int		  budget_on; /* some limit is set */
+	int		  budget_check; /* work left until getrusage(2) */
+	int		  budget_over; /* some limit was exceeded */
 	const char	 *os_s; /* default operating system */
+	mparse_part	  part; /* formatter for finished sections */
+	void		 *part_arg; /* first argument for part() */
+	struct roff_node *validated; /* last top level node validated */
+	struct roff_node *parted; /* last node passed to part() */
+	struct roff_state vstate; /* validator state between parts */
+	int		  vstarted; /* vstate is in use */
+	struct roff_node *secopen; /* last section opened */
+	unsigned int	  secwant; /* sections to keep, 0 for all */
+	unsigned int	  secseen; /* wanted sections opened so far */
+	int		  secdrop; /* secopen is not wanted */
 	int		  options; /* parser options */
 	int		  gzip; /* current input file is gzipped */
 	int		  filenc; /* encoding of the current file */
@@ -68,9 +117,19 @@ struct	mparse {
 static	void	  choose_parser(struct mparse *);
 static	void	  free_buf_list(struct buf *);
 static	void	  resize_buf(struct buf *, size_t);
-static	int	  mparse_buf_r(struct mparse *, struct buf, size_t, int);
+static	int	  mparse_buf_r(struct mparse *, struct buf, size_t, int,
+			struct buf *);
 static	int	  read_whole_file(struct mparse *, int, struct buf *, int *);
+static	int	  read_so_file(struct mparse *, int, struct buf *, int *,
+			struct socache **);
+static	void	  socache_trim(struct mparse *, size_t, int);
 static	void	  mparse_end(struct mparse *);
+static	void	  mparse_parts(struct mparse *, int);
+static	int	  mparse_secfilter(struct mparse *);
+static	void	  mparse_escapes(struct roff_node *, struct roff_node *);
+static	unsigned long mparse_cputime(const struct rusage *);
+static	void	  mparse_budget_start(struct mparse *);
+static	int	  mparse_budget_check(struct mparse *, size_t);
 
 
 static void
@@ -140,22 +199,100 @@ choose_parser(struct mparse *curp)
 	curp->man->meta.first->tok = TOKEN_NONE;
 }
 
+static unsigned long
+mparse_cputime(const struct rusage *ru)
+{
+	return (ru->ru_utime.tv_sec + ru->ru_stime.tv_sec) * 1000UL +
+	    (ru->ru_utime.tv_usec + ru->ru_stime.tv_usec) / 1000;
+}
+
+/*
+ * Start accounting for the budget of a new document.
+ */
+static void
+mparse_budget_start(struct mparse *curp)
+{
+	struct rusage	 ru;
+
+	curp->budget_bytes = 0;
+	curp->budget_nodes = curp->man->nodecount;
+	curp->budget_check = 0;
+	curp->budget_over = 0;
+	if ((curp->budget.cpu || curp->budget.memory) &&
+	    getrusage(RUSAGE_SELF, &ru) == 0) {
+		curp->budget_cpu = mparse_cputime(&ru);
+		curp->budget_rss = mandoc_stats_maxrss(&ru);
+	}
+}
+
+/*
+ * Account for an input line of len bytes after roff(7) expansion.
+ * If the document exceeded any of its limits, report that
+ * and return 1 to make the parser stop, or return 0 otherwise.
+ * Getting the resource usage costs a system call, so that is
+ * only done about every BUDGET_WORK lines or 4 kB each.
+ */
+static int
+mparse_budget_check(struct mparse *curp, size_t len)
+{
+	struct rusage	 ru;
+	const char	*name;
+	unsigned long	 limit;
+
+	if (curp->budget_over)
+		return 1;
+	curp->budget_bytes += len;
+	name = NULL;
+	limit = 0;
+	if (curp->budget.bytes && curp->budget_bytes > curp->budget.bytes) {
+		name = "bytes";
+		limit = curp->budget.bytes;
+	} else if (curp->budget.nodes &&
+	    curp->man->nodecount - curp->budget_nodes > curp->budget.nodes) {
+		name = "nodes";
+		limit = curp->budget.nodes;
+	} else if ((curp->budget.cpu || curp->budget.memory) &&
+	    (curp->budget_check -= 1 + len / 4096) <= 0 &&
+	    getrusage(RUSAGE_SELF, &ru) == 0) {
+		curp->budget_check = BUDGET_WORK;
+		if (curp->budget.cpu && mparse_cputime(&ru) -
+		    curp->budget_cpu > curp->budget.cpu) {
+			name = "cpu";
+			limit = curp->budget.cpu;
+		} else if (curp->budget.memory &&
+		    mandoc_stats_maxrss(&ru) - curp->budget_rss >
+		    (long)curp->budget.memory) {
+			name = "memory";
+			limit = curp->budget.memory;
+		}
+	}
+	if (name == NULL)
+		return 0;
+	mandoc_msg(MANDOCERR_BUDGET, curp->line, 0, "%s=%lu", name, limit);
+	curp->budget_over = 1;
+	return 1;
+}
+
 /*
  * Main parse routine for a buffer.
  * It assumes encoding and line numbering are already set up.
  * It can recurse directly (for invocations of user-defined
  * macros, inline equations, and input line traps)
  * and indirectly (for .so file inclusion).
+ * For user-defined macros, the input is a list of lines
+ * rather than a buffer, and it is reused for the lookaside list.
  */
 static int
-mparse_buf_r(struct mparse *curp, struct buf blk, size_t i, int start)
+mparse_buf_r(struct mparse *curp, struct buf blk, size_t i, int start,
+    struct buf *lines)
 {
 	struct buf	 ln;
 	struct buf	*firstln, *lastln, *thisln, *loop;
 	char		*cp;
 	size_t		 pos; /* byte number in the ln buffer */
 	size_t		 spos; /* at the start of the current line parse */
-	int		 line_result, result;
+	enum mandoc_stage stage; /* for statistics */
+	int		 line_result, macro_result, result;
 	int		 of;
 	int		 lnn; /* line number in the real file */
 	int		 fd;
@@ -166,12 +303,20 @@ mparse_buf_r(struct mparse *curp, struct buf blk, size_t i, int start)
 	ln.buf = mandoc_malloc(ln.sz);
 	ln.next = NULL;
 	firstln = lastln = loop = NULL;
+	if (lines != NULL) {
+		blk = *lines;
+		i = 0;
+	}
 	lnn = curp->line;
 	pos = 0;
 	inloop = 0;
 	result = ROFF_CONT;
+	stage = mandoc_stats_stage(MSTAGE_LINE);
 
-	while (i < blk.sz && (blk.buf[i] != '\0' || pos != 0)) {
+	while (lines != NULL ||
+	    (i < blk.sz && (blk.buf[i] != '\0' || pos != 0))) {
+		if (curp->budget_over)
+			goto out;
 		if (start) {
 			curp->line = lnn;
 			curp->reparse_count = 0;
@@ -197,6 +342,8 @@ mparse_buf_r(struct mparse *curp, struct buf blk, size_t i, int start)
 			if ('\n' == blk.buf[i]) {
 				++i;
 				++lnn;
+				if (start)
+					mandoc_stats_count(MCOUNT_LINES, 1);
 				break;
 			}
 
@@ -248,17 +395,21 @@ mparse_buf_r(struct mparse *curp, struct buf blk, size_t i, int start)
 		 * parsed from this input source.
 		 */
 
-		thisln = mandoc_malloc(sizeof(*thisln));
-		thisln->buf = mandoc_strdup(ln.buf);
-		thisln->sz = strlen(ln.buf) + 1;
-		thisln->next = NULL;
-		if (firstln == NULL) {
-			firstln = lastln = thisln;
-			if (curp->secondary == NULL)
-				curp->secondary = firstln;
-		} else {
-			lastln->next = thisln;
-			lastln = thisln;
+		if (lines != NULL && spos == 0)
+			thisln = lines;
+		else {
+			thisln = mandoc_malloc(sizeof(*thisln));
+			thisln->buf = mandoc_strdup(ln.buf);
+			thisln->sz = strlen(ln.buf) + 1;
+			thisln->next = NULL;
+			if (firstln == NULL) {
+				firstln = lastln = thisln;
+				if (curp->secondary == NULL)
+					curp->secondary = firstln;
+			} else {
+				lastln->next = thisln;
+				lastln = thisln;
+			}
 		}
 
 		/*
@@ -268,7 +419,8 @@ mparse_buf_r(struct mparse *curp, struct buf blk, size_t i, int start)
 		 * last input line ends with an escape character.
 		 */
 
-		if (i == blk.sz || blk.buf[i] == '\0') {
+		if ((i == blk.sz || blk.buf[i] == '\0') &&
+		    (lines == NULL || lines->next == NULL)) {
 			if (pos + 2 > ln.sz)
 				resize_buf(&ln, 256);
 			ln.buf[pos++] = '\n';
@@ -286,8 +438,13 @@ mparse_buf_r(struct mparse *curp, struct buf blk, size_t i, int start)
 
 		of = 0;
 rerun:
+		mandoc_stats_stage(MSTAGE_ROFF);
 		line_result = roff_parseln(curp->roff, curp->line,
 		    &ln, &of, start && spos == 0 ? pos : 0);
+		mandoc_stats_stage(MSTAGE_LINE);
+		if (curp->budget_on &&
+		    mparse_budget_check(curp, strlen(ln.buf + of)))
+			goto out;
 
 		/* Process options. */
 
@@ -352,10 +509,13 @@ rerun:
 		case ROFF_CONT:
 			if (curp->man->meta.macroset == MACROSET_NONE)
 				choose_parser(curp);
-			if ((curp->man->meta.macroset == MACROSET_MDOC ?
-			     mdoc_parseln(curp->man, curp->line, ln.buf, of) :
-			     man_parseln(curp->man, curp->line, ln.buf, of)
-			    ) == 2)
+			mandoc_stats_stage(MSTAGE_MACRO);
+			macro_result = curp->man->meta.macroset ==
+			    MACROSET_MDOC ?
+			    mdoc_parseln(curp->man, curp->line, ln.buf, of) :
+			    man_parseln(curp->man, curp->line, ln.buf, of);
+			mandoc_stats_stage(MSTAGE_LINE);
+			if (macro_result == 2)
 				goto out;
 			break;
 		case ROFF_RERUN:
@@ -368,7 +528,9 @@ rerun:
 				    curp->line, pos, NULL);
 				goto out;
 			}
-			result = mparse_buf_r(curp, ln, of, 0);
+			result = mparse_buf_r(curp, ln, of, 0,
+			    line_result & ROFF_USERCALL ?
+			    roff_userlines(curp->roff) : NULL);
 			if (line_result & ROFF_USERCALL) {
 				roff_userret(curp->roff);
 				/* Continue normally. */
@@ -398,13 +560,18 @@ rerun:
 				free(ln.buf);
 				ln.buf = cp;
 				of = 0;
-				mparse_buf_r(curp, ln, of, 0);
+				mparse_buf_r(curp, ln, of, 0, NULL);
 			}
 			break;
 		default:
 			abort();
 		}
 
+		if (start && curp->part != NULL)
+			mparse_parts(curp, 0);
+		if (start && curp->secwant != 0 && mparse_secfilter(curp))
+			goto out;
+
 		/* Start the next input line. */
 
 		if (loop != NULL &&
@@ -422,10 +589,15 @@ rerun:
 		}
 
 		pos = (line_result & ROFF_APPEND) ? strlen(ln.buf) : 0;
+		if (lines != NULL && blk.buf[i] == '\0' &&
+		    (lines = lines->next) != NULL) {
+			blk = *lines;
+			i = 0;
+		}
 	}
 out:
 	if (inloop) {
-		if (result != ROFF_USERRET)
+		if (result != ROFF_USERRET && curp->budget_over == 0)
 			mandoc_msg(MANDOCERR_WHILE_OUTOF,
 			    curp->line, pos, NULL);
 		curp->loop = NULL;
@@ -433,6 +605,7 @@ out:
 	free(ln.buf);
 	if (firstln != curp->secondary)
 		free_buf_list(firstln);
+	mandoc_stats_stage(stage);
 	return result;
 }
 
@@ -441,8 +614,9 @@ read_whole_file(struct mparse *curp, int fd, struct buf *fb, int *with_mmap)
 {
 	struct stat	 st;
 	gzFile		 gz;
-	size_t		 off;
+	size_t		 hint, off;
 	ssize_t		 ssz;
+	unsigned char	 isize[4];
 	int		 gzerrnum, retval;
 
 	if (fstat(fd, &st) == -1) {
@@ -488,6 +662,7 @@ read_whole_file(struct mparse *curp, int fd, struct buf *fb, int *with_mmap)
 			close(fd);
 			return -1;
 		}
+		(void)gzbuffer(gz, 65536);
 	} else
 		gz = NULL;
 
@@ -501,13 +676,39 @@ read_whole_file(struct mparse *curp, int fd, struct buf *fb, int *with_mmap)
 	retval = -1;
 	fb->sz = 0;
 	fb->buf = NULL;
+
+	/*
+	 * The last four bytes of a gzip(1) file contain the size
+	 * of the uncompressed data modulo 2^32.  Trust it as a hint
+	 * if it is plausible, such that the buffer usually needs
+	 * no reallocation.  The extra byte avoids doubling the
+	 * buffer merely to detect the end of file.
+	 */
+
+	if (curp->gzip && S_ISREG(st.st_mode) && st.st_size > 18 &&
+	    pread(fd, isize, sizeof(isize), st.st_size - 4) == 4) {
+		hint = (size_t)isize[0] | (size_t)isize[1] << 8 |
+		    (size_t)isize[2] << 16 | (size_t)isize[3] << 24;
+		if (hint < (1U << 31) && hint / 1032 <= (size_t)st.st_size)
+			resize_buf(fb, hint + 1);
+	}
 	for (;;) {
 		if (off == fb->sz) {
-			if (fb->sz == (1U << 31)) {
+			if (fb->sz >= (1U << 31)) {
 				mandoc_msg(MANDOCERR_TOOLARGE, 0, 0, NULL);
 				break;
 			}
-			resize_buf(fb, 65536);
+
+			/*
+			 * A size taken from the hint need not be a power
+			 * of two, so do not let doubling it skip the limit.
+			 */
+
+			if (fb->sz > (1U << 30)) {
+				fb->sz = 1U << 31;
+				fb->buf = mandoc_realloc(fb->buf, fb->sz);
+			} else
+				resize_buf(fb, 65536);
 		}
 		ssz = curp->gzip ?
 		    gzread(gz, fb->buf + (int)off, fb->sz - off) :
@@ -539,6 +740,92 @@ read_whole_file(struct mparse *curp, int fd, struct buf *fb, int *with_mmap)
 	return retval;
 }
 
+/*
+ * Read a file included with .so, reusing the contents cached from
+ * an earlier document if the file did not change in the meantime.
+ * On success, *scp is the cache entry in use, or NULL if the file
+ * is not cacheable and the caller has to release the buffer.
+ */
+static int
+read_so_file(struct mparse *curp, int fd, struct buf *fb, int *with_mmap,
+    struct socache **scp)
+{
+	struct stat	 st;
+	struct socache	*sc, **prev;
+
+	*scp = NULL;
+	if (fstat(fd, &st) == -1 || S_ISREG(st.st_mode) == 0)
+		return read_whole_file(curp, fd, fb, with_mmap);
+
+	for (prev = &curp->socache; (sc = *prev) != NULL; prev = &sc->next)
+		if (sc->ino == st.st_ino && sc->dev == st.st_dev &&
+		    sc->mtime == st.st_mtime &&
+		    sc->mtimensec == ST_MTIMENSEC(&st) &&
+		    sc->size == st.st_size && sc->gzip == curp->gzip)
+			break;
+
+	if (sc != NULL)
+		*prev = sc->next;
+	else {
+		if (read_whole_file(curp, fd, fb, with_mmap) == -1)
+			return -1;
+		if (fb->sz == 0 || fb->sz > SOCACHE_BYTES / 4)
+			return 0;
+		sc = mandoc_malloc(sizeof(*sc));
+		sc->buf = fb->buf;
+		sc->sz = fb->sz;
+		sc->dev = st.st_dev;
+		sc->ino = st.st_ino;
+		sc->mtime = st.st_mtime;
+		sc->mtimensec = ST_MTIMENSEC(&st);
+		sc->size = st.st_size;
+		sc->gzip = curp->gzip;
+		sc->mapped = *with_mmap;
+		sc->refs = 0;
+	}
+	sc->next = curp->socache;
+	curp->socache = sc;
+	sc->refs++;
+	socache_trim(curp, SOCACHE_BYTES, SOCACHE_FILES);
+
+	fb->buf = sc->buf;
+	fb->sz = sc->sz;
+	*with_mmap = 0;
+	*scp = sc;
+	return 0;
+}
+
+/*
+ * Drop the least recently used files that are not being parsed
+ * until the cache fits into the given number of bytes and files.
+ */
+static void
+socache_trim(struct mparse *curp, size_t maxsz, int maxfiles)
+{
+	struct socache	*sc, **prev;
+	size_t		 sz;
+	int		 files;
+
+	sz = 0;
+	files = 0;
+	prev = &curp->socache;
+	while ((sc = *prev) != NULL) {
+		if (sc->refs == 0 &&
+		    (sz + sc->sz > maxsz || files >= maxfiles)) {
+			*prev = sc->next;
+			if (sc->mapped)
+				munmap(sc->buf, sc->sz);
+			else
+				free(sc->buf);
+			free(sc);
+			continue;
+		}
+		sz += sc->sz;
+		files++;
+		prev = &sc->next;
+	}
+}
+
 static void
 mparse_end(struct mparse *curp)
 {
@@ -549,6 +836,156 @@ mparse_end(struct mparse *curp)
 	else
 		man_endparse(curp->man);
 	roff_endparse(curp->roff);
+	if (curp->secdrop) {
+		roff_node_delete(curp->man, curp->secopen);
+		curp->secopen = NULL;
+		curp->secdrop = 0;
+	}
+}
+
+/*
+ * Validate top level nodes that are complete and, unless this is
+ * the final call at the end of the document, hand them over to
+ * the formatter.  The parsers only ever add content to the last
+ * child of the root node, so once a new section has been opened,
+ * all preceding top level nodes are finished.
+ * Validating a node may still delete the preceding node, unless
+ * that one is transparent, so hold back the last validated
+ * node that isn't, and everything after it.
+ */
+static void
+mparse_parts(struct mparse *curp, int final)
+{
+	struct roff_state	 pstate;
+	struct roff_man		*man;
+	struct roff_node	*root, *first, *n;
+	enum mandoc_stage	 stage;
+
+	man = curp->man;
+	root = man->meta.first;
+	n = curp->validated == NULL ? root->child : curp->validated->next;
+	if (final == 0 && (n == NULL || n == root->last ||
+	    root->last->type != ROFFT_BLOCK ||
+	    (root->last->tok != MDOC_Sh && root->last->tok != MAN_SH)))
+		return;
+
+	stage = mandoc_stats_stage(MSTAGE_VALIDATE);
+	roff_state_save(man, &pstate);
+	if (curp->vstarted)
+		roff_state_load(man, &curp->vstate);
+	else {
+		roff_state_reset(man);
+		curp->vstarted = 1;
+	}
+	while (n != NULL && (final || n != root->last)) {
+		man->last = n;
+		if (man->meta.macroset == MACROSET_MDOC)
+			mdoc_validate(man);
+		else
+			man_validate(man);
+
+		/* The validator may have deleted or replaced the node. */
+
+		if (man->last != root && man->last != curp->validated) {
+			curp->validated = man->last;
+			tag_postprocess(man, curp->validated);
+		}
+		n = curp->validated == NULL ? root->child :
+		    curp->validated->next;
+	}
+	mandoc_stats_stage(stage);
+	if (final)
+		return;
+
+	roff_state_save(man, &curp->vstate);
+	roff_state_load(man, &pstate);
+
+	for (n = curp->validated; n != NULL; n = n->prev)
+		if (roff_node_transparent(n) == 0)
+			break;
+	if (n == NULL || (n = n->prev) == NULL || n == curp->parted)
+		return;
+	first = curp->parted == NULL ? root->child : curp->parted->next;
+	if (curp->options & MPARSE_ESCAPES) {
+		stage = mandoc_stats_stage(MSTAGE_POST);
+		mparse_escapes(first, n);
+		mandoc_stats_stage(stage);
+	}
+	curp->parted = n;
+	(*curp->part)(curp->part_arg, &man->meta, n);
+}
+
+/*
+ * Decode the escape sequences in all text nodes from first up to
+ * and including the sibling last, or to the end if last is NULL.
+ * This must be done after validation because some validation
+ * functions change the strings of text nodes.
+ */
+static void
+mparse_escapes(struct roff_node *first, struct roff_node *last)
+{
+	struct roff_node	*n;
+
+	for (n = first; n != NULL; n = n->next) {
+		if (n->type == ROFFT_TEXT && n->esc == NULL)
+			n->esc = roff_escdecode(n->string);
+		if (n->child != NULL)
+			mparse_escapes(n->child, NULL);
+		if (n == last)
+			break;
+	}
+}
+
+/*
+ * When only some sections are wanted, discard each other section
+ * as soon as the next one is opened, such that it is neither kept
+ * in memory nor validated, and return 1 to stop parsing once all
+ * wanted sections have been closed.
+ */
+static int
+mparse_secfilter(struct mparse *curp)
+{
+	struct roff_node	*n;
+	char			*cp;
+	enum roff_sec		 sec;
+
+	if (curp->secwant == curp->secseen && curp->secopen == NULL)
+		return 1;
+
+	n = curp->man->meta.first->last;
+	if (n == NULL || n == curp->secopen || n->type != ROFFT_BLOCK ||
+	    (n->tok != MDOC_Sh && n->tok != MAN_SH) ||
+	    n->last == NULL || n->last->type != ROFFT_BODY)
+		return 0;
+
+	if (curp->secdrop)
+		roff_node_delete(curp->man, curp->secopen);
+	if (curp->secwant == curp->secseen) {
+		curp->secopen = NULL;
+		curp->secdrop = 0;
+		return 1;
+	}
+
+	/*
+	 * For man(7), like the formatters, also accept headers
+	 * like "SYNOPSIS AND DESCRIPTION" by their first word.
+	 */
+
+	if (n->tok == MDOC_Sh)
+		sec = n->sec;
+	else {
+		cp = NULL;
+		deroff(&cp, n->head);
+		sec = cp == NULL ? SEC_CUSTOM : mdoc_a2sec(cp);
+		free(cp);
+		if (sec == SEC_CUSTOM && n->head->child != NULL &&
+		    n->head->child->type == ROFFT_TEXT)
+			sec = mdoc_a2sec(n->head->child->string);
+	}
+	curp->secopen = n;
+	curp->secdrop = (curp->secwant & (1U << sec)) == 0;
+	curp->secseen |= curp->secwant & (1U << sec);
+	return 0;
 }
 
 /*
@@ -562,10 +999,12 @@ mparse_readfd(struct mparse *curp, int fd, const char *filename)
 
 	struct buf	 blk;
 	struct buf	*save_primary;
+	struct socache	*sc;
 	const char	*save_filename, *cp;
 	size_t		 offset;
+	enum mandoc_stage stage;
 	int		 save_filenc, save_lineno;
-	int		 with_mmap;
+	int		 with_mmap, rc;
 
 	if (recursion_depth > 64) {
 		mandoc_msg(MANDOCERR_ROFFLOOP, curp->line, 0, NULL);
@@ -577,8 +1016,19 @@ mparse_readfd(struct mparse *curp, int fd, const char *filename)
         else
                 curp->man->filesec = '\0';
 
-	if (read_whole_file(curp, fd, &blk, &with_mmap) == -1)
+	stage = mandoc_stats_stage(MSTAGE_READ);
+	if (recursion_depth == 0) {
+		sc = NULL;
+		rc = read_whole_file(curp, fd, &blk, &with_mmap);
+	} else
+		rc = read_so_file(curp, fd, &blk, &with_mmap, &sc);
+	mandoc_stats_stage(stage);
+	if (rc == -1)
 		return;
+	mandoc_stats_count(MCOUNT_FILES, 1);
+	mandoc_stats_count(MCOUNT_BYTES, blk.sz);
+	if (recursion_depth == 0 && curp->budget_on)
+		mparse_budget_start(curp);
 
 	/*
 	 * Save some properties of the parent file.
@@ -605,7 +1055,7 @@ mparse_readfd(struct mparse *curp, int fd, const char *filename)
 		offset = 0;
 
 	recursion_depth++;
-	mparse_buf_r(curp, blk, offset, 1);
+	mparse_buf_r(curp, blk, offset, 1, NULL);
 	if (--recursion_depth == 0)
 		mparse_end(curp);
 
@@ -613,7 +1063,9 @@ mparse_readfd(struct mparse *curp, int fd, const char *filename)
 	 * Clean up and restore saved parent properties.
 	 */
 
-	if (with_mmap)
+	if (sc != NULL)
+		sc->refs--;
+	else if (with_mmap)
 		munmap(blk.buf, blk.sz);
 	else
 		free(blk.buf);
@@ -690,6 +1142,42 @@ mparse_alloc(int options, enum mandoc_os os_e, const char *os_s)
 	return curp;
 }
 
+/*
+ * Set the limits for each of the following documents.
+ */
+void
+mparse_budget(struct mparse *curp, const struct mparse_budget *budget)
+{
+	curp->budget = *budget;
+	curp->budget_on = budget->cpu || budget->bytes ||
+	    budget->nodes || budget->memory;
+	curp->budget_over = 0;
+}
+
+/*
+ * Set one limit from an argument of the form "name=value".
+ * Return 0 on success or -1 if the argument is invalid.
+ */
+int
+mparse_budget_arg(struct mparse_budget *budget, const char *arg)
+{
+	const char	*errstr;
+	unsigned long	*limit;
+
+	if (strncmp(arg, "cpu=", 4) == 0)
+		limit = &budget->cpu;
+	else if (strncmp(arg, "bytes=", 6) == 0)
+		limit = &budget->bytes;
+	else if (strncmp(arg, "nodes=", 6) == 0)
+		limit = &budget->nodes;
+	else if (strncmp(arg, "memory=", 7) == 0)
+		limit = &budget->memory;
+	else
+		return -1;
+	*limit = strtonum(strchr(arg, '=') + 1, 0, LONG_MAX, &errstr);
+	return errstr == NULL ? 0 : -1;
+}
+
 void
 mparse_reset(struct mparse *curp)
 {
@@ -699,6 +1187,11 @@ mparse_reset(struct mparse *curp)
 	free_buf_list(curp->secondary);
 	curp->secondary = NULL;
 	curp->gzip = 0;
+	curp->validated = curp->parted = NULL;
+	curp->vstarted = 0;
+	curp->secopen = NULL;
+	curp->secseen = 0;
+	curp->secdrop = 0;
 	tag_alloc();
 }
 
@@ -711,19 +1204,66 @@ mparse_free(struct mparse *curp)
 	roff_man_free(curp->man);
 	roff_free(curp->roff);
 	free_buf_list(curp->secondary);
+	socache_trim(curp, 0, 0);
 	free(curp);
 }
 
+/*
+ * In streaming mode, call part() with the meta data and the last
+ * node of each group of top level nodes as soon as these are parsed
+ * and validated.  The last group is not passed to part(); it is
+ * completed by mparse_result() and has to be handled by the caller.
+ * The tree is still under construction when part() is called;
+ * the formatter must not look beyond the node it was passed.
+ */
+void
+mparse_stream(struct mparse *curp, mparse_part part, void *arg)
+{
+	curp->part = (curp->options & MPARSE_VALIDATE) ? part : NULL;
+	curp->part_arg = arg;
+}
+
+/*
+ * Only keep the sections given as a bit mask indexed by
+ * enum roff_sec, and stop parsing as soon as all of them are closed.
+ * Text before the first section header is always kept.
+ * Zero means that all sections are wanted.
+ */
+void
+mparse_sections(struct mparse *curp, unsigned int mask)
+{
+	curp->secwant = mask;
+}
+
 struct roff_meta *
 mparse_result(struct mparse *curp)
 {
-	roff_state_reset(curp->man);
+	enum mandoc_stage	 stage;
+
+	if (curp->vstarted == 0)
+		roff_state_reset(curp->man);
 	if (curp->options & MPARSE_VALIDATE) {
-		if (curp->man->meta.macroset == MACROSET_MDOC)
-			mdoc_validate(curp->man);
-		else
-			man_validate(curp->man);
-		tag_postprocess(curp->man, curp->man->meta.first);
+		stage = mandoc_stats_stage(MSTAGE_VALIDATE);
+		if (curp->vstarted) {
+			mparse_parts(curp, 1);
+			if (curp->man->meta.macroset == MACROSET_MDOC)
+				mdoc_validate_root(curp->man);
+			else
+				man_validate_root(curp->man);
+			mandoc_stats_stage(MSTAGE_POST);
+		} else {
+			if (curp->man->meta.macroset == MACROSET_MDOC)
+				mdoc_validate(curp->man);
+			else
+				man_validate(curp->man);
+			mandoc_stats_stage(MSTAGE_POST);
+			tag_postprocess(curp->man, curp->man->meta.first);
+		}
+		if (curp->options & MPARSE_ESCAPES)
+			mparse_escapes(curp->parted == NULL ?
+			    curp->man->meta.first :
+			    curp->parted->next, NULL);
+		mandoc_stats_stage(stage);
 	}
 	return &curp->man->meta;
 }
@@ -0,0 +1,275 @@
+#!/usr/bin/env perl
+#
+# $Id$
+#
+# Copyright (c) 2026 The mandoc developers <tech@mandoc.bsd.lv>
+#
+# Permission to use, copy, modify, and distribute this software for any
+# purpose with or without fee is hereby granted, provided that the above
+# copyright notice and this permission notice appear in all copies.
+#
+# THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+# WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+# MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+# ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+# WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+# ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+# OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+use warnings;
+use strict;
+
+use File::Find qw(find);
+use File::Temp qw(tempdir);
+use Getopt::Std qw(getopts);
+
+# --- utility functions ------------------------------------------------
+
+sub usage ($) {
+	warn shift;
+	print STDERR "usage: $0 [-v] [-b baseline] [-n runs] [-s scale] ",
+	    "[-t percent] [input ...]\n";
+	exit 1;
+}
+
+my %opts;
+getopts 'b:n:s:t:v', \%opts or usage "invalid option\n";
+my $runs = $opts{n} // 3;
+my $scale = $opts{s} // 1;
+my $threshold = $opts{t} // 10;
+$runs =~ /^[1-9]\d*$/ or usage "-n $runs: invalid number of runs\n";
+$scale =~ /^[1-9]\d*$/ or usage "-s $scale: invalid scale\n";
+$threshold =~ /^\d+$/ or usage "-t $threshold: invalid percentage\n";
+
+my @devices = qw(lint ascii utf8 html markdown man pdf);
+my $tmpdir = tempdir 'bench.XXXXXXXXXX', TMPDIR => 1, CLEANUP => 1;
+
+# Write a file into the temporary directory and return its path.
+# 1st argument: file name
+# The remaining arguments are the lines to write.
+sub writefile ($@) {
+	my $fn = "$tmpdir/" . shift;
+	open my $fh, '>', $fn or die "$fn: $!";
+	print $fh "$_\n" for @_;
+	close $fh;
+	return $fn;
+}
+
+# --- synthetic input files --------------------------------------------
+
+# Deeply nested mdoc(7) lists of various types.
+sub gen_bl () {
+	my @lines = ('.Dd January 1, 2026', '.Dt BL 7', '.Os',
+	    '.Sh NAME', '.Nm bl', '.Nd deeply nested lists',
+	    '.Sh DESCRIPTION');
+	my @types = ('-tag -width Ds', '-bullet', '-enum', '-dash -compact',
+	    '-hang -width 6n', '-ohang', '-column xxxx yyyy');
+	for my $outer (1 .. 50 * $scale) {
+		for my $depth (0 .. 39) {
+			my $type = $types[$depth % @types];
+			push @lines, ".Bl $type";
+			if ($type =~ /^-column/) {
+				push @lines, ".It a Ta b", ".It c Ta d";
+			} elsif ($type =~ /^-(tag|hang|ohang)/) {
+				push @lines, ".It Cm item$depth Ar arg",
+				    "Text at depth $depth.";
+			} else {
+				push @lines, '.It', "Text at depth $depth.";
+			}
+		}
+		push @lines, ('.El') x 40;
+	}
+	return writefile 'bl.7', @lines;
+}
+
+# A huge tbl(7) table with text blocks and spans.
+sub gen_tbl () {
+	my @lines = ('.TH TBL 1 2026-01-01', '.SH NAME', 'tbl \- huge table',
+	    '.SH DESCRIPTION', '.TS', 'allbox tab(:);', 'lb c n r l l.',
+	    'name:centre:number:right:left:block');
+	for my $row (1 .. 5000 * $scale) {
+		if ($row % 10) {
+			push @lines, "row$row:c$row:$row.5:r:\\fBbold\\fP:text";
+		} else {
+			push @lines, "row$row:c$row:$row:r:l:T{",
+			    "A text block in row $row with \\(em escapes",
+			    "that spans more than one input line.", 'T}', '_';
+		}
+	}
+	push @lines, '.TE';
+	return writefile 'tbl.1', @lines;
+}
+
+# Many user-defined macros, called many times.
+sub gen_de () {
+	my @lines = ('.TH DE 1 2026-01-01', '.SH NAME',
+	    'de \- user-defined macros', '.SH DESCRIPTION');
+	for my $i (1 .. 200) {
+		push @lines, ".de M$i", '.ie \\\\n(.$>1 .BR \\\\$1 \\\\$2',
+		    '.el .B \\\\$1', "text of macro $i", '..';
+	}
+	for my $call (1 .. 20000 * $scale) {
+		my $i = 1 + $call % 200;
+		push @lines, ".M$i word$call arg$call";
+	}
+	return writefile 'de.1', @lines;
+}
+
+# Long lines full of escape sequences.
+sub gen_esc () {
+	my @lines = ('.TH ESC 1 2026-01-01', '.SH NAME',
+	    'esc \- escape sequences', '.ds S1 interpolated string',
+	    '.nr R1 42', '.SH DESCRIPTION');
+	my $chunk = 'a \\fBb\\fR \\(em \\*[S1] \\n[R1] \\[u00E9] \\e \\-x ' .
+	    '\\w\'abc\' \\s+2z\\s0 \\h\'1n\' \\fIi\\fP\\(lq\\*(Lq\\(rq';
+	push @lines, join ' ', ($chunk) x 20 for 1 .. 2000 * $scale;
+	return writefile 'esc.1', @lines;
+}
+
+# --- inputs -----------------------------------------------------------
+
+my @regress_files;
+find sub { push @regress_files, $File::Find::name if /\.in$/ }, '.';
+@regress_files = sort @regress_files;
+
+my %generators = (
+	bl => \&gen_bl,
+	de => \&gen_de,
+	esc => \&gen_esc,
+	tbl => \&gen_tbl,
+);
+my @inputs = @ARGV ? @ARGV : ('regress', sort keys %generators);
+my %files;
+for my $input (@inputs) {
+	if ($input eq 'regress') {
+		$files{$input} = \@regress_files;
+	} elsif (defined $generators{$input}) {
+		$files{$input} = [ $generators{$input}->() ];
+	} else {
+		usage "$input: unknown input\n";
+	}
+}
+
+# --- measurements -----------------------------------------------------
+
+# Run mandoc(1) on one file and return its statistics report
+# as a reference to a hash, or undef if it did not finish.
+# 1st argument: output device
+# 2nd argument: input file
+sub runone ($$) {
+	my ($device, $file) = @_;
+	my $report = "$tmpdir/stats";
+	unlink $report;
+	local $ENV{MANDOC_STATS} = $report;
+	print "../mandoc -T $device $file\n" if $opts{v};
+	my $pid = fork // die "fork: $!";
+	if ($pid == 0) {
+		open STDOUT, '>', '/dev/null' or die "/dev/null: $!";
+		open STDERR, '>', '/dev/null' or die "/dev/null: $!";
+		exec '../mandoc', '-T', $device, $file;
+		die "exec: $!";
+	}
+	waitpid $pid, 0;
+	return undef if $? & 127;
+	open my $fh, '<', $report or return undef;
+	my %stats;
+	while (<$fh>) {
+		my ($type, $name, $value) = split;
+		$stats{$name} = $value unless $type eq 'P';
+	}
+	close $fh;
+	return \%stats;
+}
+
+# Results indexed by "input device", each an array of
+# total, parse, validate, format [ns/byte], allocs, maxrss [kB].
+my %results;
+my %crashed;
+for my $input (@inputs) {
+	for my $device (@devices) {
+		my $best;
+		for (1 .. $runs) {
+			my @sum = (0) x 6;
+			my $bytes = 0;
+			for my $file (@{$files{$input}}) {
+				next if $crashed{"$device $file"};
+				my $s = runone $device, $file;
+				unless (defined $s) {
+					warn "$device $file: crashed\n";
+					$crashed{"$device $file"} = 1;
+					next;
+				}
+				my @t = map { $s->{$_} } qw(read line roff
+				    macro validate post format);
+				$sum[1] += $t[0] + $t[1] + $t[2] + $t[3];
+				$sum[2] += $t[4] + $t[5];
+				$sum[3] += $t[6];
+				$sum[4] += $s->{allocs};
+				$sum[5] = $s->{maxrss} if $s->{maxrss} > $sum[5];
+				$bytes += $s->{bytes};
+			}
+			next unless $bytes;
+			$sum[$_] *= 1000 / $bytes for 1 .. 3;
+			$sum[0] = $sum[1] + $sum[2] + $sum[3];
+			if (defined $best) {
+				$best->[$_] = $sum[$_] < $best->[$_] ?
+				    $sum[$_] : $best->[$_] for 0 .. 3;
+			} else {
+				$best = \@sum;
+			}
+		}
+		$results{"$input $device"} = $best if defined $best;
+	}
+}
+
+# --- report -----------------------------------------------------------
+
+my @columns = qw(total parse valid format allocs maxrss);
+my $format = "%-8s %-9s %9.1f %9.1f %9.1f %9.1f %11d %8d\n";
+printf "# %-6s %-9s %9s %9s %9s %9s %11s %8s\n",
+    'input', 'device', @columns;
+for my $input (@inputs) {
+	for my $device (@devices) {
+		my $r = $results{"$input $device"} or next;
+		printf $format, $input, $device, @$r;
+	}
+}
+exit 0 unless defined $opts{b};
+
+# Compare the total time, allocations, and memory usage to the
+# baseline and fail if any of them grew by more than the threshold.
+my %baseline;
+open my $fh, '<', $opts{b} or die "$opts{b}: $!";
+while (<$fh>) {
+	next if /^#/;
+	my ($input, $device, @values) = split;
+	$baseline{"$input $device"} = \@values;
+}
+close $fh;
+
+my $regressions = 0;
+print "\nchanges relative to $opts{b}:\n";
+for my $input (@inputs) {
+	for my $device (@devices) {
+		my $r = $results{"$input $device"} or next;
+		my $b = $baseline{"$input $device"} or next;
+		my @change;
+		for my $i (0, 4, 5) {
+			my $pct = $b->[$i] ?
+			    100 * ($r->[$i] - $b->[$i]) / $b->[$i] : 0;
+			my $mark = ' ';
+			if ($pct > $threshold) {
+				$mark = '!';
+				$regressions++;
+			}
+			push @change, sprintf "%s %+6.1f%%%s",
+			    $columns[$i], $pct, $mark;
+		}
+		printf "%-8s %-9s %s\n", $input, $device, join '  ', @change;
+	}
+}
+if ($regressions) {
+	print "\n$regressions regressions above $threshold%\n";
+	exit 1;
+}
+exit 0;
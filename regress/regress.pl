@@ -109,6 +109,32 @@ sub syshtml ($@) {
 	return 0;
 }
 
+# Simlar, but filter the output as needed for the pdf test:
+# compressed stream data, their lengths, and the byte offsets
+# in the cross-reference table depend on the zlib(3) version.
+sub syspdf ($@) {
+	my $outfile = shift;
+	print "@_\n" if $targets{verbose};
+	open my $outfd, '>', $outfile or die "$outfile: $!";
+	my $infd;
+	my $pid = open3 undef, $infd, undef, @_;
+	my $state = 0;
+	while (<$infd>) {
+		if ($state) {
+			$state = 0 if /^endstream$/;
+			next;
+		}
+		$state = 1 if /^stream$/;
+		s/^\d+$/length/;
+		s/^\d{10} (\d{5} [fn])/offset $1/;
+		print $outfd $_;
+	}
+	close $outfd;
+	close $infd;
+	waitpid $pid, 0;
+	return 0;
+}
+
 my @failures;
 sub fail ($$) {
 	warn "FAILED: @_\n";
@@ -120,16 +146,18 @@ sub fail ($$) {
 
 my $onlytest = shift // '';
 for (@ARGV) {
-	/^(all|ascii|tag|man|utf8|html|markdown|lint|clean|verbose)$/
+	/^(all|ascii|tag|man|utf8|html|markdown|lint|ps|pdf|clean|verbose)$/
 	    or usage "$_: invalid modifier";
 	$targets{$_} = 1;
 }
 $targets{all} = 1
     unless $targets{ascii} || $targets{tag} || $targets{man} ||
       $targets{utf8} || $targets{html} || $targets{markdown} ||
-      $targets{lint} || $targets{clean};
+      $targets{lint} || $targets{ps} || $targets{pdf} ||
+      $targets{clean};
 $targets{ascii} = $targets{tag} = $targets{man} = $targets{utf8} =
-    $targets{html} = $targets{markdown} = $targets{lint} = 1
+    $targets{html} = $targets{markdown} = $targets{lint} =
+    $targets{ps} = $targets{pdf} = 1
     if $targets{all};
 
 
@@ -158,6 +186,7 @@ sub parse_makefile ($%) {
 }
 
 my (@regress_tests, @utf8_tests, @lint_tests, @html_tests);
+my (@ps_tests, @pdf_tests);
 my (%tag_tests, %skip_ascii, %skip_man, %skip_markdown);
 foreach my $module (qw(roff char mdoc man tbl eqn)) {
 	my %modvars;
@@ -207,6 +236,20 @@ foreach my $module (qw(roff char mdoc man tbl eqn)) {
 			} foreach split ' ', $subvars{LINT_TARGETS};
 			delete $subvars{LINT_TARGETS};
 		}
+		if (defined $subvars{PS_TARGETS}) {
+			push @ps_tests, {
+			    NAME => "$module/$subdir/$_",
+			    MOPTS => \@mopts,
+			} foreach split ' ', $subvars{PS_TARGETS};
+			delete $subvars{PS_TARGETS};
+		}
+		if (defined $subvars{PDF_TARGETS}) {
+			push @pdf_tests, {
+			    NAME => "$module/$subdir/$_",
+			    MOPTS => \@mopts,
+			} foreach split ' ', $subvars{PDF_TARGETS};
+			delete $subvars{PDF_TARGETS};
+		}
 		if (defined $subvars{SKIP_ASCII}) {
 			for (split ' ', $subvars{SKIP_ASCII}) {
 				$skip_ascii{"$module/$subdir/$_"} = 1;
@@ -436,6 +479,67 @@ if ($targets{lint}) {
 	print " $count_lint tests run.\n";
 }
 
+# The ps and pdf tests format NAME.in together with
+# all NAME_*.in files, such that they can check books.
+
+my $count_ps = 0;
+if ($targets{ps}) {
+	print "Running ps tests ";
+	print "...\n" if $targets{verbose};
+}
+for my $test (@ps_tests) {
+	my @i = ("$test->{NAME}.in", sort glob "$test->{NAME}_*.in");
+	my $o = "$test->{NAME}.mandoc_ps";
+	my $w = "$test->{NAME}.out_ps";
+	if ($targets{ps} && $test->{NAME} =~ /^$onlytest/) {
+		$count_ps++;
+		$count_total++;
+		sysout $o, '../mandoc', @{$test->{MOPTS}},
+		    qw(-I os=OpenBSD -T ps), @i
+		    and fail $test->{NAME}, 'ps:mandoc';
+		system @diff, $w, $o
+		    and fail $test->{NAME}, 'ps:diff';
+		print "." unless $targets{verbose};
+	}
+	if ($targets{clean}) {
+		print "rm $o\n" if $targets{verbose};
+		$count_rm += unlink $o;
+	}
+}
+if ($targets{ps}) {
+	print "Number of ps tests:" if $targets{verbose};
+	print " $count_ps tests run.\n";
+}
+
+my $count_pdf = 0;
+if ($targets{pdf}) {
+	print "Running pdf tests ";
+	print "...\n" if $targets{verbose};
+}
+for my $test (@pdf_tests) {
+	my @i = ("$test->{NAME}.in", sort glob "$test->{NAME}_*.in");
+	my $o = "$test->{NAME}.mandoc_pdf";
+	my $w = "$test->{NAME}.out_pdf";
+	if ($targets{pdf} && $test->{NAME} =~ /^$onlytest/) {
+		$count_pdf++;
+		$count_total++;
+		syspdf $o, '../mandoc', @{$test->{MOPTS}},
+		    qw(-I os=OpenBSD -T pdf), @i
+		    and fail $test->{NAME}, 'pdf:mandoc';
+		system @diff, $w, $o
+		    and fail $test->{NAME}, 'pdf:diff';
+		print "." unless $targets{verbose};
+	}
+	if ($targets{clean}) {
+		print "rm $o\n" if $targets{verbose};
+		$count_rm += unlink $o;
+	}
+}
+if ($targets{pdf}) {
+	print "Number of pdf tests:" if $targets{verbose};
+	print " $count_pdf tests run.\n";
+}
+
 # --- final report -----------------------------------------------------
 
 if (@failures) {
@@ -457,6 +561,8 @@ if ($count_total == 1) {
 	print " $count_html html" if $count_html;
 	print " $count_markdown markdown" if $count_markdown;
 	print " $count_lint lint" if $count_lint;
+	print " $count_ps ps" if $count_ps;
+	print " $count_pdf pdf" if $count_pdf;
 	print "\n";
 } else {
 	print "No tests were run.\n";
@@ -52,8 +52,22 @@
 			 ROFFDEF_REN | ROFFDEF_STD)
 #define	ROFFDEF_UNDEF	(1 << 5)  /* Completely undefined. */
 
+/* Number of syntax tree nodes allocated at once. */
+#define	ROFF_CHUNKSZ	256
+
+/* Longest text node string that is shared among nodes. */
+#define	ROFF_WORDMAX	24
+
 /* --- data types --------------------------------------------------------- */
 
+/*
+ * Memory for syntax tree nodes, freed with the document.
+ */
+struct	roff_chunk {
+	struct roff_chunk *next;
+	struct roff_node  nodes[ROFF_CHUNKSZ];
+};
+
 /*
  * An incredibly-simple string buffer.
  */
@@ -68,9 +82,20 @@ struct	roffstr {
 struct	roffkv {
 	struct roffstr	 key;
 	struct roffstr	 val;
+	struct roffbody	*body; /* val split into lines, or NULL */
 	struct roffkv	*next; /* next in list */
 };
 
+/*
+ * A macro definition split into lines once for all its calls.
+ * It is shared by the string table entry and by all running calls,
+ * such that redefining a macro while it runs is safe.
+ */
+struct	roffbody {
+	int		 refs;	/* Number of users. */
+	struct buf	 lines[];  /* Linked list, followed by the text. */
+};
+
 /*
  * A single number register as part of a singly-linked list.
  */
@@ -95,6 +120,7 @@ struct	roffreq {
  */
 struct	mctx {
 	char		**argv;
+	struct roffbody	 *body;
 	int		 argc;
 	int		 argsz;
 };
@@ -111,6 +137,7 @@ struct	roff {
 	struct roffkv	*xmbtab; /* multi-byte trans table (`tr') */
 	struct roffstr	*xtab; /* single-byte trans table (`tr') */
 	const char	*current_string; /* value of last called user macro */
+	struct roffkv	*current_kv; /* entry of last called user macro */
 	struct tbl_node	*first_tbl; /* first table parsed */
 	struct tbl_node	*last_tbl; /* last table parsed */
 	struct tbl_node	*tbl; /* current table being parsed */
@@ -198,10 +225,11 @@ static	int		 roff_evalpar(int, const char *, int *, int *,
 static	int		 roff_evalstrcond(const char *, int *);
 static	int		 roff_expand(struct roff *, struct buf *,
 				int, int, char);
-static	void		 roff_expand_patch(struct buf *, int,
-				const char *, int);
+static	char		*roff_expand_patch(struct buf *, int *, int *,
+				int, int, int, int);
 static	void		 roff_free1(struct roff *);
 static	void		 roff_freereg(struct roffreg *);
+static	void		 roff_freebody(struct roffbody *);
 static	void		 roff_freestr(struct roffkv *);
 static	size_t		 roff_getname(char **, int, int);
 static	int		 roff_getnum(const char *, int *, int *, char, int);
@@ -211,7 +239,7 @@ static	int		 roff_getregn(struct roff *,
 static	int		 roff_getregro(const struct roff *,
 				const char *name);
 static	const char	*roff_getstrn(struct roff *,
-				const char *, size_t, int *);
+				const char *, size_t, int *, struct roffkv **);
 static	int		 roff_hasregn(const struct roff *,
 				const char *, size_t);
 static	int		 roff_insec(ROFF_ARGS);
@@ -219,6 +247,7 @@ static	int		 roff_it(ROFF_ARGS);
 static	int		 roff_line_ignore(ROFF_ARGS);
 static	void		 roff_man_alloc1(struct roff_man *);
 static	void		 roff_man_free1(struct roff_man *);
+static	struct roff_node *roff_node_get(struct roff_man *);
 static	int		 roff_manyarg(ROFF_ARGS);
 static	int		 roff_mc(ROFF_ARGS);
 static	int		 roff_noarg(ROFF_ARGS);
@@ -255,6 +284,7 @@ static	int		 roff_EN(ROFF_ARGS);
 static	int		 roff_T_(ROFF_ARGS);
 static	int		 roff_unsupp(ROFF_ARGS);
 static	int		 roff_userdef(ROFF_ARGS);
+static	struct roffbody	*roff_userbody(struct roff *);
 
 /* --- constant data ------------------------------------------------------ */
 
@@ -829,8 +859,23 @@ roff_alloc(int options)
 static void
 roff_man_free1(struct roff_man *man)
 {
+	struct roff_chunk	*cp;
+	char			*word;
+	unsigned int		 slot;
+
 	if (man->meta.first != NULL)
 		roff_node_delete(man, man->meta.first);
+	for (word = ohash_first(man->words, &slot); word != NULL;
+	     word = ohash_next(man->words, &slot))
+		free(word);
+	ohash_delete(man->words);
+	while ((cp = man->chunks) != NULL) {
+		man->chunks = cp->next;
+		free(cp);
+	}
+	man->freenodes = NULL;
+	man->chunkused = 0;
+	eqn_pool_reset(man->eqnpool);
 	free(man->meta.msec);
 	free(man->meta.vol);
 	free(man->meta.os);
@@ -852,11 +897,36 @@ roff_state_reset(struct roff_man *man)
 	roff_setreg(man->roff, "nS", 0, '=');
 }
 
+void
+roff_state_save(struct roff_man *man, struct roff_state *st)
+{
+	st->last = man->last;
+	st->last_es = man->last_es;
+	st->flags = man->flags;
+	st->lastsec = man->lastsec;
+	st->lastnamed = man->lastnamed;
+	st->next = man->next;
+	st->nS = roff_getreg(man->roff, "nS");
+}
+
+void
+roff_state_load(struct roff_man *man, const struct roff_state *st)
+{
+	man->last = st->last;
+	man->last_es = st->last_es;
+	man->flags = st->flags;
+	man->lastsec = st->lastsec;
+	man->lastnamed = st->lastnamed;
+	man->next = st->next;
+	roff_setreg(man->roff, "nS", st->nS, '=');
+}
+
 static void
 roff_man_alloc1(struct roff_man *man)
 {
 	memset(&man->meta, 0, sizeof(man->meta));
-	man->meta.first = mandoc_calloc(1, sizeof(*man->meta.first));
+	mandoc_ohash_init(man->words, 8, 0);
+	man->meta.first = roff_node_get(man);
 	man->meta.first->type = ROFFT_ROOT;
 	man->meta.macroset = MACROSET_NONE;
 	roff_state_reset(man);
@@ -873,6 +943,8 @@ void
 roff_man_free(struct roff_man *man)
 {
 	roff_man_free1(man);
+	eqn_pool_free(man->eqnpool);
+	free(man->words);
 	free(man->os_r);
 	free(man);
 }
@@ -886,6 +958,8 @@ roff_man_alloc(struct roff *roff, const char *os_s, int quick)
 	man->roff = roff;
 	man->os_s = os_s;
 	man->quick = quick;
+	man->words = mandoc_malloc(sizeof(*man->words));
+	man->eqnpool = eqn_pool_alloc();
 	roff_man_alloc1(man);
 	roff->man = man;
 	return man;
@@ -893,13 +967,41 @@ roff_man_alloc(struct roff *roff, const char *os_s, int quick)
 
 /* --- syntax tree handling ----------------------------------------------- */
 
+/*
+ * Get a zeroed node from the chunks of the current document,
+ * preferring nodes that were deleted earlier.
+ * Consecutive nodes are mostly adjacent in memory.
+ */
+static struct roff_node *
+roff_node_get(struct roff_man *man)
+{
+	struct roff_chunk	*cp;
+	struct roff_node	*n;
+
+	if ((n = man->freenodes) != NULL)
+		man->freenodes = n->next;
+	else {
+		if (man->chunks == NULL || man->chunkused == ROFF_CHUNKSZ) {
+			cp = mandoc_malloc(sizeof(*cp));
+			cp->next = man->chunks;
+			man->chunks = cp;
+			man->chunkused = 0;
+		}
+		n = man->chunks->nodes + man->chunkused++;
+	}
+	memset(n, 0, sizeof(*n));
+	return n;
+}
+
 struct roff_node *
 roff_node_alloc(struct roff_man *man, int line, int pos,
 	enum roff_type type, int tok)
 {
 	struct roff_node	*n;
 
-	n = mandoc_calloc(1, sizeof(*n));
+	n = roff_node_get(man);
+	man->nodecount++;
+	mandoc_stats_count(MCOUNT_NODES, 1);
 	n->line = line;
 	n->pos = pos;
 	n->tok = tok;
@@ -975,13 +1077,54 @@ roff_node_append(struct roff_man *man, struct roff_node *n)
 	assert(n->parent->type == ROFFT_BLOCK);
 }
 
+/*
+ * Short words recur all over a manual page, so text nodes share
+ * one copy of each per document unless a .tr request is in effect.
+ * Shared strings must not be modified or freed;
+ * use roff_word_own() to get a private copy first.
+ */
+static void
+roff_word_set(struct roff_man *man, struct roff_node *n, const char *word)
+{
+	const char	*end;
+	char		*cp;
+	unsigned int	 slot;
+
+	if (man->roff->xtab != NULL || man->roff->xmbtab != NULL ||
+	    (end = memchr(word, '\0', ROFF_WORDMAX + 1)) == NULL) {
+		n->string = roff_strdup(man->roff, word);
+		return;
+	}
+	slot = ohash_qlookupi(man->words, word, &end);
+	if ((cp = ohash_find(man->words, slot)) == NULL) {
+		cp = mandoc_strdup(word);
+		ohash_insert(man->words, slot, cp);
+	}
+	n->string = cp;
+	n->shared = 1;
+}
+
+/*
+ * Make sure that the string of a text node is not shared,
+ * such that it can be modified in place, and return it.
+ */
+char *
+roff_word_own(struct roff_node *n)
+{
+	if (n->shared) {
+		n->string = mandoc_strdup(n->string);
+		n->shared = 0;
+	}
+	return n->string;
+}
+
 void
 roff_word_alloc(struct roff_man *man, int line, int pos, const char *word)
 {
 	struct roff_node	*n;
 
 	n = roff_node_alloc(man, line, pos, ROFFT_TEXT, TOKEN_NONE);
-	n->string = roff_strdup(man->roff, word);
+	roff_word_set(man, n, word);
 	roff_node_append(man, n);
 	n->flags |= NODE_VALID | NODE_ENDED;
 	man->next = ROFF_NEXT_SIBLING;
@@ -997,8 +1140,10 @@ roff_word_append(struct roff_man *man, const char *word)
 	addstr = roff_strdup(man->roff, word);
 	mandoc_asprintf(&newstr, "%s %s", n->string, addstr);
 	free(addstr);
-	free(n->string);
+	if (n->shared == 0)
+		free(n->string);
 	n->string = newstr;
+	n->shared = 0;
 	man->next = ROFF_NEXT_SIBLING;
 }
 
@@ -1135,17 +1280,23 @@ roff_node_relink(struct roff_man *man, struct roff_node *n)
 }
 
 void
-roff_node_free(struct roff_node *n)
+roff_node_free(struct roff_man *man, struct roff_node *n)
 {
 
 	if (n->args != NULL)
 		mdoc_argv_free(n->args);
 	if (n->type == ROFFT_BLOCK || n->type == ROFFT_ELEM)
 		free(n->norm);
-	eqn_box_free(n->eqn);
-	free(n->string);
+	eqn_box_free(man->eqnpool, n->eqn);
+	if (n->shared == 0)
+		free(n->string);
+	free(n->esc);
 	free(n->tag);
-	free(n);
+
+	/* The memory itself is only released with the document. */
+
+	n->next = man->freenodes;
+	man->freenodes = n;
 }
 
 void
@@ -1155,7 +1306,7 @@ roff_node_delete(struct roff_man *man, struct roff_node *n)
 	while (n->child != NULL)
 		roff_node_delete(man, n->child);
 	roff_node_unlink(man, n);
-	roff_node_free(n);
+	roff_node_free(man, n);
 }
 
 int
@@ -1394,6 +1545,11 @@ roff_parse_comment(struct roff *r, struct buf *buf, int ln, int pos, char ec)
  * In the current line, expand escape sequences that produce parsable
  * input text.  Also check the syntax of the remaining escape sequences,
  * which typically produce output glyphs or change formatter state.
+ *
+ * The expanded text is written to the beginning of the buffer
+ * in a single pass from left to right.  The input that still needs
+ * to be scanned, including freshly pasted text, is kept gap bytes
+ * further towards the end, and all indices refer to the input.
  */
 static int
 roff_expand(struct roff *r, struct buf *buf, int ln, int pos, char ec)
@@ -1402,8 +1558,11 @@ roff_expand(struct roff *r, struct buf *buf, int ln, int pos, char ec)
 	struct mctx	*ctx;		/* current macro call context */
 	const char	*res;		/* the string to be pasted */
 	const char	*src;		/* source for copying */
+	char		*in;		/* input text, at buf->buf + gap */
 	char		*dst;		/* destination for copying */
 	enum mandoc_esc	 subtype;	/* return value from roff_escape */
+	int		 gap;		/* distance of input from output */
+	int		 iendl;		/* index of the terminating NUL */
 	int		 iesc;		/* index of leading escape char */
 	int		 inam;		/* index of the escape name */
 	int		 iarg;		/* index beginning the argument */
@@ -1418,8 +1577,11 @@ roff_expand(struct roff *r, struct buf *buf, int ln, int pos, char ec)
 	int		 npos;		/* position in numeric expression */
 	int		 expand_count;	/* to avoid infinite loops */
 
+	in = buf->buf;
+	gap = 0;
+	iendl = pos + strlen(in + pos);
 	expand_count = 0;
-	while (buf->buf[pos] != '\0') {
+	while (in[pos] != '\0') {
 
 		/*
 		 * Skip plain ASCII characters.
@@ -1428,11 +1590,15 @@ roff_expand(struct roff *r, struct buf *buf, int ln, int pos, char ec)
 		 * subsequent functions uses the standard escaping rules.
 		 */
 
-		if (buf->buf[pos] != ec) {
-			if (buf->buf[pos] == '\\') {
-				roff_expand_patch(buf, pos, "\\e", pos + 1);
+		if (in[pos] != ec) {
+			if (in[pos] == '\\') {
+				in = roff_expand_patch(buf, &gap, &iendl,
+				    pos, pos, pos + 1, 2);
+				memcpy(in + pos, "\\e", 2);
+				buf->buf[pos] = in[pos];
 				pos++;
 			}
+			buf->buf[pos] = in[pos];
 			pos++;
 			continue;
 		}
@@ -1445,35 +1611,41 @@ roff_expand(struct roff *r, struct buf *buf, int ln, int pos, char ec)
 		 * it to backslashes and translate backslashes to \e.
 		 */
 
-		if (roff_escape(buf->buf, ln, pos, &iesc, &inam,
+		if (roff_escape(in, ln, pos, &iesc, &inam,
 		    &iarg, &iendarg, &iend) != ESCAPE_EXPAND) {
 			while (pos < iend) {
-				if (buf->buf[pos] == ec) {
-					buf->buf[pos] = '\\';
-					if (pos + 1 < iend)
+				if (in[pos] == ec) {
+					in[pos] = '\\';
+					if (pos + 1 < iend) {
+						buf->buf[pos] = in[pos];
 						pos++;
-				} else if (buf->buf[pos] == '\\') {
-					roff_expand_patch(buf,
-					    pos, "\\e", pos + 1);
+					}
+				} else if (in[pos] == '\\') {
+					in = roff_expand_patch(buf, &gap,
+					    &iendl, pos, pos, pos + 1, 2);
+					memcpy(in + pos, "\\e", 2);
+					buf->buf[pos] = in[pos];
 					pos++;
 					iend++;
 				}
+				buf->buf[pos] = in[pos];
 				pos++;
 			}
 			continue;
 		}
+		mandoc_stats_count(MCOUNT_ESCAPES, 1);
 
 		/* Reduce \\ and \. in names. */
 
-		if (buf->buf[inam] == '*' || buf->buf[inam] == 'n') {
+		if (in[inam] == '*' || in[inam] == 'n') {
 			isrc = idst = iarg;
 			while (isrc < iendarg) {
 				if (isrc + 1 < iendarg &&
-				    buf->buf[isrc] == '\\' &&
-				    (buf->buf[isrc + 1] == '\\' ||
-				     buf->buf[isrc + 1] == '.'))
+				    in[isrc] == '\\' &&
+				    (in[isrc + 1] == '\\' ||
+				     in[isrc + 1] == '.'))
 					isrc++;
-				buf->buf[idst++] = buf->buf[isrc++];
+				in[idst++] = in[isrc++];
 			}
 			iendarg -= isrc - idst;
 		}
@@ -1481,13 +1653,13 @@ roff_expand(struct roff *r, struct buf *buf, int ln, int pos, char ec)
 		/* Handle expansion. */
 
 		res = NULL;
-		switch (buf->buf[inam]) {
+		switch (in[inam]) {
 		case '*':
 			if (iendarg == iarg)
 				break;
 			deftype = ROFFDEF_USER | ROFFDEF_PRE;
-			if ((res = roff_getstrn(r, buf->buf + iarg,
-			    iendarg - iarg, &deftype)) != NULL)
+			if ((res = roff_getstrn(r, in + iarg,
+			    iendarg - iarg, &deftype, NULL)) != NULL)
 				break;
 
 			/*
@@ -1496,37 +1668,40 @@ roff_expand(struct roff *r, struct buf *buf, int ln, int pos, char ec)
 			 */
 
 			if (iendarg - iarg == 2 &&
-			    buf->buf[iarg] == '.' &&
-			    buf->buf[iarg + 1] == 'T') {
+			    in[iarg] == '.' &&
+			    in[iarg + 1] == 'T') {
 				roff_setstrn(&r->strtab, ".T", 2, NULL, 0, 0);
-				pos = iend;
+				while (pos < iend) {
+					buf->buf[pos] = in[pos];
+					pos++;
+				}
 				continue;
 			}
 
 			mandoc_msg(MANDOCERR_STR_UNDEF, ln, iesc,
-			    "%.*s", iendarg - iarg, buf->buf + iarg);
+			    "%.*s", iendarg - iarg, in + iarg);
 			break;
 
 		case '$':
 			if (r->mstackpos < 0) {
 				mandoc_msg(MANDOCERR_ARG_UNDEF, ln, iesc,
-				    "%.*s", iend - iesc, buf->buf + iesc);
+				    "%.*s", iend - iesc, in + iesc);
 				break;
 			}
 			ctx = r->mstack + r->mstackpos;
-			argi = buf->buf[iarg] - '1';
+			argi = in[iarg] - '1';
 			if (argi >= 0 && argi <= 8) {
 				if (argi < ctx->argc)
 					res = ctx->argv[argi];
 				break;
 			}
-			if (buf->buf[iarg] == '*')
+			if (in[iarg] == '*')
 				quote_args = 0;
-			else if (buf->buf[iarg] == '@')
+			else if (in[iarg] == '@')
 				quote_args = 1;
 			else {
 				mandoc_msg(MANDOCERR_ARG_NONUM, ln, iesc,
-				    "%.*s", iend - iesc, buf->buf + iesc);
+				    "%.*s", iend - iesc, in + iesc);
 				break;
 			}
 			asz = 0;
@@ -1537,18 +1712,9 @@ roff_expand(struct roff *r, struct buf *buf, int ln, int pos, char ec)
 					asz += 2;  /* quotes */
 				asz += strlen(ctx->argv[argi]);
 			}
-			if (asz != iend - iesc) {
-				rsz = buf->sz - iend;
-				if (asz < iend - iesc)
-					memmove(buf->buf + iesc + asz,
-					    buf->buf + iend, rsz);
-				buf->sz = iesc + asz + rsz;
-				buf->buf = mandoc_realloc(buf->buf, buf->sz);
-				if (asz > iend - iesc)
-					memmove(buf->buf + iesc + asz,
-					    buf->buf + iend, rsz);
-			}
-			dst = buf->buf + iesc;
+			in = roff_expand_patch(buf, &gap, &iendl,
+			    pos, iesc, iend, asz);
+			dst = in + iesc;
 			for (argi = 0; argi < ctx->argc; argi++) {
 				if (argi)
 					*dst++ = ' ';
@@ -1569,7 +1735,7 @@ roff_expand(struct roff *r, struct buf *buf, int ln, int pos, char ec)
 		case 'B':
 			npos = 0;
 			ubuf[0] = iendarg > iarg && iend > iendarg &&
-			    roff_evalnum(ln, buf->buf + iarg, &npos,
+			    roff_evalnum(ln, in + iarg, &npos,
 					 NULL, 'u', 0) &&
 			    npos == iendarg - iarg ? '1' : '0';
 			ubuf[1] = '\0';
@@ -1577,17 +1743,21 @@ roff_expand(struct roff *r, struct buf *buf, int ln, int pos, char ec)
 			break;
 		case 'V':
 			mandoc_msg(MANDOCERR_UNSUPP, ln, iesc,
-			    "%.*s", iend - iesc, buf->buf + iesc);
-			roff_expand_patch(buf, iendarg, "}", iend);
-			roff_expand_patch(buf, iesc, "${", iarg);
+			    "%.*s", iend - iesc, in + iesc);
+			in = roff_expand_patch(buf, &gap, &iendl,
+			    pos, iendarg, iend, 1);
+			in[iendarg] = '}';
+			in = roff_expand_patch(buf, &gap, &iendl,
+			    pos, iesc, iarg, 2);
+			memcpy(in + iesc, "${", 2);
 			continue;
 		case 'g':
 			break;
 		case 'n':
 			if (iendarg > iarg)
 				(void)snprintf(ubuf, sizeof(ubuf), "%d",
-				    roff_getregn(r, buf->buf + iarg,
-				    iendarg - iarg, buf->buf[inam + 1]));
+				    roff_getregn(r, in + iarg,
+				    iendarg - iarg, in[inam + 1]));
 			else
 				ubuf[0] = '\0';
 			res = ubuf;
@@ -1597,12 +1767,12 @@ roff_expand(struct roff *r, struct buf *buf, int ln, int pos, char ec)
 			subtype = ESCAPE_UNDEF;
 			while (iarg < iendarg) {
 				asz = subtype == ESCAPE_SKIPCHAR ? 0 : 1;
-				if (buf->buf[iarg] != '\\') {
+				if (in[iarg] != '\\') {
 					rsz += asz;
 					iarg++;
 					continue;
 				}
-				switch ((subtype = roff_escape(buf->buf, 0,
+				switch ((subtype = roff_escape(in, 0,
 				    iarg, NULL, NULL, NULL, NULL, &iarg))) {
 				case ESCAPE_SPECIAL:
 				case ESCAPE_NUMBERED:
@@ -1628,29 +1798,49 @@ roff_expand(struct roff *r, struct buf *buf, int ln, int pos, char ec)
 		}
 		if (res == NULL)
 			res = "";
+		asz = strlen(res);
 		if (++expand_count > EXPAND_LIMIT ||
-		    buf->sz + strlen(res) > SHRT_MAX) {
+		    iendl + asz >= SHRT_MAX) {
 			mandoc_msg(MANDOCERR_ROFFLOOP, ln, iesc, NULL);
 			return ROFF_IGN;
 		}
-		roff_expand_patch(buf, iesc, res, iend);
+		in = roff_expand_patch(buf, &gap, &iendl,
+		    pos, iesc, iend, asz);
+		memcpy(in + iesc, res, asz);
 	}
+	buf->buf[pos] = '\0';
 	return ROFF_CONT;
 }
 
 /*
- * Replace the substring from the start position (inclusive)
- * to end position (exclusive) with the repl(acement) string.
+ * Replace the input from the start index (inclusive) to the
+ * end index (exclusive) with sz bytes to be filled in by the caller.
+ * Input that was not yet scanned, from pos to start, is kept.
+ * Only if the gap between output and input is too small,
+ * move the rest of the line to the end of the buffer,
+ * growing the buffer if needed.
+ * Return the new location of the input.
  */
-static void
-roff_expand_patch(struct buf *buf, int start, const char *repl, int end)
+static char *
+roff_expand_patch(struct buf *buf, int *gap, int *iendl,
+    int pos, int start, int end, int sz)
 {
-	char	*nbuf;
-
-	buf->sz = mandoc_asprintf(&nbuf, "%.*s%s%s", start, buf->buf,
-	    repl, buf->buf + end) + 1;
-	free(buf->buf);
-	buf->buf = nbuf;
+	size_t	 nsz;
+	int	 ngap, rsz;
+
+	if ((ngap = *gap + (end - start) - sz) < 0) {
+		rsz = *iendl - end + 1;
+		if ((nsz = start + sz + rsz) > buf->sz) {
+			buf->sz = nsz * 2;
+			buf->buf = mandoc_realloc(buf->buf, buf->sz);
+		}
+		memmove(buf->buf + buf->sz - rsz, buf->buf + *gap + end, rsz);
+		ngap = buf->sz - rsz - start - sz;
+	}
+	memmove(buf->buf + ngap + pos, buf->buf + *gap + pos, start - pos);
+	*gap = ngap;
+	*iendl += sz - (end - start);
+	return buf->buf + ngap;
 }
 
 /*
@@ -1998,9 +2188,21 @@ roff_userret(struct roff *r)
 	for (i = 0; i < ctx->argc; i++)
 		free(ctx->argv[i]);
 	ctx->argc = 0;
+	roff_freebody(ctx->body);
+	ctx->body = NULL;
 	r->mstackpos--;
 }
 
+/*
+ * Return the lines of the user-defined macro currently being called.
+ */
+struct buf *
+roff_userlines(struct roff *r)
+{
+	assert(r->mstackpos >= 0);
+	return r->mstack[r->mstackpos].body->lines;
+}
+
 void
 roff_endparse(struct roff *r)
 {
@@ -2023,7 +2225,8 @@ roff_endparse(struct roff *r)
  * Parse the request or macro name at buf[*pos].
  * Return ROFF_RENAMED, ROFF_USERDEF, or a ROFF_* token value.
  * For empty, undefined, mdoc(7), and man(7) macros, return TOKEN_NONE.
- * As a side effect, set r->current_string to the definition or to NULL.
+ * As a side effect, set r->current_string to the definition or to NULL
+ * and r->current_kv to the string table entry of a user-defined macro.
  */
 static enum roff_tok
 roff_parse(struct roff *r, char *buf, int *pos, int ln, int ppos)
@@ -2043,7 +2246,8 @@ roff_parse(struct roff *r, char *buf, int *pos, int ln, int ppos)
 	maclen = roff_getname(&cp, ln, ppos);
 
 	deftype = ROFFDEF_USER | ROFFDEF_REN;
-	r->current_string = roff_getstrn(r, mac, maclen, &deftype);
+	r->current_string = roff_getstrn(r, mac, maclen, &deftype,
+	    &r->current_kv);
 	switch (deftype) {
 	case ROFFDEF_USER:
 		t = ROFF_USERDEF;
@@ -2201,7 +2405,7 @@ roff_block(ROFF_ARGS)
 
 	if (namesz && (tok == ROFF_dei || tok == ROFF_ami)) {
 		deftype = ROFFDEF_USER;
-		name = roff_getstrn(r, iname, namesz, &deftype);
+		name = roff_getstrn(r, iname, namesz, &deftype, NULL);
 		if (name == NULL) {
 			mandoc_msg(MANDOCERR_STR_UNDEF,
 			    ln, (int)(iname - buf->buf),
@@ -2231,7 +2435,7 @@ roff_block(ROFF_ARGS)
 		roff_setstrn(&r->rentab, name, namesz, NULL, 0, 0);
 	} else if (tok == ROFF_am || tok == ROFF_ami) {
 		deftype = ROFFDEF_ANY;
-		value = roff_getstrn(r, iname, namesz, &deftype);
+		value = roff_getstrn(r, iname, namesz, &deftype, NULL);
 		switch (deftype) {  /* Before appending, ... */
 		case ROFFDEF_PRE: /* copy predefined to user-defined. */
 			roff_setstrn(&r->strtab, name, namesz,
@@ -2270,7 +2474,7 @@ roff_block(ROFF_ARGS)
 
 	if (namesz && (tok == ROFF_dei || tok == ROFF_ami)) {
 		deftype = ROFFDEF_USER;
-		name = roff_getstrn(r, iname, namesz, &deftype);
+		name = roff_getstrn(r, iname, namesz, &deftype, NULL);
 		if (name == NULL) {
 			mandoc_msg(MANDOCERR_STR_UNDEF,
 			    ln, (int)(iname - buf->buf),
@@ -2668,7 +2872,7 @@ roff_evalcond(struct roff *r, int ln, char *v, int *pos)
 			istrue = roff_hasregn(r, name, sz);
 		else {
 			deftype = ROFFDEF_ANY;
-		        roff_getstrn(r, name, sz, &deftype);
+		        roff_getstrn(r, name, sz, &deftype, NULL);
 			istrue = !!deftype;
 		}
 		*pos = (name + sz) - v;
@@ -3436,13 +3640,13 @@ roff_EQ(ROFF_ARGS)
 	n = roff_node_alloc(r->man, ln, ppos, ROFFT_EQN, TOKEN_NONE);
 	if (ln > r->man->last->line)
 		n->flags |= NODE_LINE;
-	n->eqn = eqn_box_new();
+	n->eqn = eqn_box_new(r->man->eqnpool);
 	roff_node_append(r->man, n);
 	r->man->next = ROFF_NEXT_SIBLING;
 
 	assert(r->eqn == NULL);
 	if (r->last_eqn == NULL)
-		r->last_eqn = eqn_alloc();
+		r->last_eqn = eqn_alloc(r->man->eqnpool);
 	else
 		eqn_reset(r->last_eqn);
 	r->eqn = r->last_eqn;
@@ -3889,7 +4093,7 @@ roff_rn(ROFF_ARGS)
 		return ROFF_IGN;
 
 	deftype = ROFFDEF_ANY;
-	value = roff_getstrn(r, oldn, oldsz, &deftype);
+	value = roff_getstrn(r, oldn, oldsz, &deftype, NULL);
 	switch (deftype) {
 	case ROFFDEF_USER:
 		roff_setstrn(&r->strtab, newn, newsz, value, strlen(value), 0);
@@ -3987,6 +4191,7 @@ roff_so(ROFF_ARGS)
 static int
 roff_stringup(ROFF_ARGS)
 {
+	struct roffkv	*n;
 	const char	*name;
 	char		*cp;
 	size_t		 namesz;
@@ -3999,7 +4204,10 @@ roff_stringup(ROFF_ARGS)
 		mandoc_msg(MANDOCERR_ARG_EXCESS, ln, (int)(cp - buf->buf),
 		    "%s ... %s", roff_name[tok], cp);
 	deftype = ROFFDEF_USER;
-	if ((cp = (char *)roff_getstrn(r, name, namesz, &deftype)) != NULL) {
+	if ((cp = (char *)roff_getstrn(r, name, namesz,
+	    &deftype, &n)) != NULL) {
+		roff_freebody(n->body);
+		n->body = NULL;
 		while (*cp != '\0') {
 			if (tok == ROFF_stringup)
 				*cp = toupper(*cp);
@@ -4024,6 +4232,7 @@ roff_userdef(ROFF_ARGS)
 
 	if (*r->current_string == '\0')
 		return ROFF_IGN;
+	mandoc_stats_count(MCOUNT_MACROS, 1);
 
 	/* Initialize a new macro stack context. */
 
@@ -4063,15 +4272,68 @@ roff_userdef(ROFF_ARGS)
 		free(arg);
 	}
 
-	/* Replace the macro invocation by the macro definition. */
+	/*
+	 * If the definition ends with a newline, the parser
+	 * processes its lines, see roff_userlines().
+	 * Otherwise, replace the macro invocation by the definition
+	 * and join it with the next input line.
+	 */
 
+	if (strchr(r->current_string, '\0')[-1] == '\n') {
+		ctx->body = roff_userbody(r);
+		return ROFF_REPARSE | ROFF_USERCALL;
+	}
 	free(buf->buf);
 	buf->buf = mandoc_strdup(r->current_string);
 	buf->sz = strlen(buf->buf) + 1;
 	*offs = 0;
+	return ROFF_IGN | ROFF_APPEND;
+}
+
+/*
+ * Return the definition of the user-defined macro being called
+ * split into lines, splitting it if this is the first call
+ * since it was last defined or modified.
+ */
+static struct roffbody *
+roff_userbody(struct roff *r)
+{
+	struct roffkv	*n;
+	struct roffbody	*b;
+	struct buf	*ln;
+	const char	*cp;
+	char		*p, *ep;
+	size_t		 sz;
+	int		 nl;
+
+	n = r->current_kv;
+	if ((b = n->body) == NULL) {
+		nl = 0;
+		for (cp = n->val.p; (cp = strchr(cp, '\n')) != NULL; cp++)
+			nl++;
+		sz = sizeof(*b) + nl * sizeof(*b->lines);
+		n->body = b = mandoc_malloc(sz + n->val.sz + 1);
+		b->refs = 1;
+		p = (char *)b + sz;
+		memcpy(p, n->val.p, n->val.sz + 1);
+		for (ln = b->lines; nl > 0; ln++, nl--) {
+			ep = strchr(p, '\n');
+			*ep = '\0';
+			ln->buf = p;
+			ln->sz = ep - p + 1;
+			ln->next = nl > 1 ? ln + 1 : NULL;
+			p = ep + 1;
+		}
+	}
+	b->refs++;
+	return b;
+}
 
-	return buf->buf[buf->sz - 2] == '\n' ?
-	    ROFF_REPARSE | ROFF_USERCALL : ROFF_IGN | ROFF_APPEND;
+static void
+roff_freebody(struct roffbody *b)
+{
+	if (b != NULL && --b->refs == 0)
+		free(b);
 }
 
 /*
@@ -4200,12 +4462,17 @@ roff_setstrn(struct roffkv **r, const char *name, size_t namesz,
 		n->key.sz = namesz;
 		n->val.p = NULL;
 		n->val.sz = 0;
+		n->body = NULL;
 		n->next = *r;
 		*r = n;
-	} else if (0 == append) {
-		free(n->val.p);
-		n->val.p = NULL;
-		n->val.sz = 0;
+	} else {
+		roff_freebody(n->body);
+		n->body = NULL;
+		if (0 == append) {
+			free(n->val.p);
+			n->val.p = NULL;
+			n->val.sz = 0;
+		}
 	}
 
 	if (NULL == string)
@@ -4251,12 +4518,14 @@ roff_setstrn(struct roffkv **r, const char *name, size_t namesz,
 
 static const char *
 roff_getstrn(struct roff *r, const char *name, size_t len,
-    int *deftype)
+    int *deftype, struct roffkv **kvp)
 {
-	const struct roffkv	*n;
+	struct roffkv		*n;
 	int			 found, i;
 	enum roff_tok		 tok;
 
+	if (kvp != NULL)
+		*kvp = NULL;
 	found = 0;
 	for (n = r->strtab; n != NULL; n = n->next) {
 		if (strncmp(name, n->key.p, len) != 0 ||
@@ -4264,6 +4533,8 @@ roff_getstrn(struct roff *r, const char *name, size_t len,
 			continue;
 		if (*deftype & ROFFDEF_USER) {
 			*deftype = ROFFDEF_USER;
+			if (kvp != NULL)
+				*kvp = n;
 			return n->val.p;
 		} else {
 			found = 1;
@@ -4351,6 +4622,7 @@ roff_freestr(struct roffkv *r)
 	for (n = r; n; n = nn) {
 		free(n->key.p);
 		free(n->val.p);
+		roff_freebody(n->body);
 		nn = n->next;
 		free(n);
 	}
@@ -508,6 +508,19 @@ enum	mandoc_os {
 	MANDOC_OS_OPENBSD
 };
 
+/*
+ * An escape sequence in the string of a text node,
+ * decoded by the parser such that formatters need not parse it again.
+ * Arrays of these are terminated by an entry with end == 0.
+ */
+struct	roff_esc {
+	int		  type;    /* enum mandoc_esc */
+	int		  arg;     /* Byte offset of the argument. */
+	int		  sz;      /* Length of the argument in bytes. */
+	int		  end;     /* Byte offset after the sequence. */
+	int		  uc;      /* Code point of a character, or -1. */
+};
+
 struct	roff_node {
 	struct roff_node *parent;  /* Parent AST node. */
 	struct roff_node *child;   /* First child AST node. */
@@ -520,6 +533,7 @@ struct	roff_node {
 	struct mdoc_arg	 *args;    /* BLOCK/ELEM */
 	union mdoc_data	 *norm;    /* Normalized arguments. */
 	char		 *string;  /* TEXT */
+	struct roff_esc	 *esc;     /* TEXT: decoded escapes, if any. */
 	char		 *tag;     /* For less(1) :t and HTML id=. */
 	struct tbl_span	 *span;    /* TBL */
 	struct eqn_box	 *eqn;     /* EQN */
@@ -541,6 +555,7 @@ struct	roff_node {
 #define	NODE_HREF	 (1 << 12) /* Link to another place in this page. */
 	int		  prev_font; /* Before entering this node. */
 	int		  aux;     /* Decoded node data, type-dependent. */
+	int		  shared;  /* TEXT: string owned by the document. */
 	enum roff_tok	  tok;     /* Request or macro ID. */
 	enum roff_type	  type;    /* AST node type. */
 	enum roff_sec	  sec;     /* Current named section. */
@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "mandoc_aux.h"
 #include "mandoc.h"
 #include "roff.h"
 #include "roff_int.h"
@@ -551,3 +552,55 @@ out:
 		mandoc_msg(err, ln, iesc, "%.*s", iend - iesc, buf + iesc);
 	return rval;
 }
+
+/*
+ * Decode all escape sequences in the string of a text node in advance,
+ * including the code points of character escape sequences, such that
+ * the formatters need not call mandoc_escape() for each of them.
+ * Return NULL if the string does not contain any escape sequences.
+ */
+struct roff_esc *
+roff_escdecode(const char *s)
+{
+	struct roff_esc	*esc, *ep;
+	const char	*cp, *arg;
+	size_t		 i, sz;
+	int		 argl;
+
+	if ((cp = strchr(s, '\\')) == NULL)
+		return NULL;
+
+	esc = NULL;
+	i = sz = 0;
+	do {
+		if (i + 1 >= sz) {
+			sz = sz == 0 ? 4 : sz * 2;
+			esc = mandoc_reallocarray(esc, sz, sizeof(*esc));
+		}
+		ep = esc + i++;
+		cp++;
+		ep->type = mandoc_escape(&cp, &arg, &argl);
+		ep->arg = arg - s;
+		ep->sz = argl;
+		ep->end = cp - s;
+		switch (ep->type) {
+		case ESCAPE_UNICODE:
+			ep->uc = mchars_num2uc(arg + 1, argl - 1);
+			break;
+		case ESCAPE_NUMBERED:
+			ep->uc = mchars_num2char(arg, argl);
+			break;
+		case ESCAPE_SPECIAL:
+			ep->uc = mchars_spec2cp(arg, argl);
+			break;
+		case ESCAPE_UNDEF:
+			ep->uc = *arg;
+			break;
+		default:
+			ep->uc = -1;
+			break;
+		}
+	} while ((cp = strchr(cp, '\\')) != NULL);
+	esc[i].end = 0;
+	return esc;
+}
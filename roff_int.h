@@ -19,6 +19,8 @@
  */
 
 struct	ohash;
+struct	eqn_pool;
+struct	roff_chunk;
 struct	roff_node;
 struct	roff_meta;
 struct	roff;
@@ -38,6 +40,12 @@ struct	roff_man {
 	char	 	 *os_r;    /* Operating system name at run time. */
 	struct roff_node *last;    /* The last node parsed. */
 	struct roff_node *last_es; /* The most recent Es node. */
+	struct ohash	 *words;   /* Text node strings shared in this document. */
+	struct roff_chunk *chunks; /* Memory for the nodes, newest first. */
+	struct roff_node *freenodes; /* Deleted nodes available for reuse. */
+	size_t		  chunkused; /* Nodes used in the newest chunk. */
+	struct eqn_pool	 *eqnpool; /* Memory for the eqn boxes. */
+	unsigned long	  nodecount; /* Nodes allocated so far. */
 	int		  quick;   /* Abort parse early. */
 	int		  flags;   /* Parse flags. */
 #define	ROFF_NOFILL	 (1 << 1)  /* Fill mode switched off. */
@@ -63,28 +71,48 @@ struct	roff_man {
 	char		  filesec; /* Section digit in the file name. */
 };
 
+/*
+ * The parts of struct roff_man that are used by both the parsers
+ * and the validators, such that they can be saved while validation
+ * runs interleaved with parsing.
+ */
+struct	roff_state {
+	struct roff_node *last;
+	struct roff_node *last_es;
+	int		  flags;
+	enum roff_sec	  lastsec;
+	enum roff_sec	  lastnamed;
+	enum roff_next	  next;
+	int		  nS;	   /* Value of the nS register. */
+};
+
 
 struct roff_node *roff_node_alloc(struct roff_man *, int, int,
 			enum roff_type, int);
 void		  roff_node_append(struct roff_man *, struct roff_node *);
 void		  roff_word_alloc(struct roff_man *, int, int, const char *);
 void		  roff_word_append(struct roff_man *, const char *);
+char		 *roff_word_own(struct roff_node *);
 void		  roff_elem_alloc(struct roff_man *, int, int, int);
 struct roff_node *roff_block_alloc(struct roff_man *, int, int, int);
 struct roff_node *roff_head_alloc(struct roff_man *, int, int, int);
 struct roff_node *roff_body_alloc(struct roff_man *, int, int, int);
 void		  roff_node_unlink(struct roff_man *, struct roff_node *);
 void		  roff_node_relink(struct roff_man *, struct roff_node *);
-void		  roff_node_free(struct roff_node *);
+void		  roff_node_free(struct roff_man *, struct roff_node *);
 void		  roff_node_delete(struct roff_man *, struct roff_node *);
 
 struct ohash	 *roffhash_alloc(enum roff_tok, enum roff_tok);
 enum roff_tok	  roffhash_find(struct ohash *, const char *, size_t);
 void		  roffhash_free(struct ohash *);
 
+struct roff_esc	 *roff_escdecode(const char *);
 enum mandoc_esc	  roff_escape(const char *, const int, const int,
 			int *, int *, int *, int *, int *);
 void		  roff_state_reset(struct roff_man *);
+void		  roff_state_save(struct roff_man *, struct roff_state *);
+void		  roff_state_load(struct roff_man *,
+			const struct roff_state *);
 void		  roff_validate(struct roff_man *);
 
 /*
@@ -46,6 +46,8 @@ struct tag_entry {
 	char	 s[];
 };
 
+static void		 tag_move_entry(struct roff_node *,
+				struct roff_node *);
 static void		 tag_move_href(struct roff_man *,
 				struct roff_node *, const char *);
 static void		 tag_move_id(struct roff_node *);
@@ -239,6 +241,25 @@ tag_exists(const char *tag)
 	return ohash_find(&tag_data, ohash_qlookup(&tag_data, tag)) != NULL;
 }
 
+/*
+ * After moving a tag from node n to node np, make sure that
+ * a better tag found later is still able to clear it.
+ * That matters when the formatter runs before parsing ends.
+ */
+static void
+tag_move_entry(struct roff_node *n, struct roff_node *np)
+{
+	struct tag_entry	*entry;
+	size_t			 i;
+
+	entry = ohash_find(&tag_data, ohash_qlookup(&tag_data, np->tag));
+	if (entry == NULL)
+		return;
+	for (i = 0; i < entry->nnodes; i++)
+		if (entry->nodes[i] == n)
+			entry->nodes[i] = np;
+}
+
 /*
  * For in-line elements, move the link target
  * to the enclosing paragraph when appropriate.
@@ -280,6 +301,7 @@ tag_move_id(struct roff_node *n)
 				    n->child->string : n->tag);
 				np->flags |= NODE_ID;
 				n->flags &= ~NODE_ID;
+				tag_move_entry(n, np);
 			}
 			return;
 		case MDOC_Sh:
@@ -309,6 +331,7 @@ static void
 tag_move_href(struct roff_man *man, struct roff_node *n, const char *tag)
 {
 	char	*cp;
+	size_t	 off;
 
 	if (n == NULL || n->type != ROFFT_TEXT ||
 	    *n->string == '\0' || *n->string == ' ')
@@ -326,7 +349,8 @@ tag_move_href(struct roff_man *man, struct roff_node *n, const char *tag)
 		roff_word_alloc(man, n->line,
 		    n->pos + (cp - n->string), cp + 1);
 		man->last->flags = n->flags & ~NODE_LINE;
-		*cp = '\0';
+		off = cp - n->string;
+		roff_word_own(n)[off] = '\0';
 	}
 
 	assert(n->tag == NULL);
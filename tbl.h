@@ -94,6 +94,7 @@ struct	tbl_dat {
 	struct tbl_dat	 *next;    /* Data cell to the right. */
 	struct tbl_cell	 *layout;  /* Associated layout cell. */
 	char		 *string;  /* Data, or NULL if not TBL_DATA_DATA. */
+	int		  align;   /* Offset of alignment point, or -1. */
 	int		  hspans;  /* How many horizontal spans follow. */
 	int		  vspans;  /* How many vertical spans follow. */
 	int		  block;   /* T{ text block T} */
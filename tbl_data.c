@@ -34,12 +34,51 @@
 #include "libmandoc.h"
 #include "tbl_int.h"
 
+static	void		 getalign(const struct tbl_node *,
+				struct tbl_dat *);
 static	void		 getdata(struct tbl_node *, struct tbl_span *,
 				int, const char *, int *);
 static	struct tbl_span	*newspan(struct tbl_node *, int,
 				struct tbl_row *);
 
 
+/*
+ * For numerically aligned cells, find the point to align:
+ * the last decimal point that is adjacent to a digit, or else
+ * the position after the last digit.  The alignment indicator
+ * "\&" overrides everything.  If there are no digits at all,
+ * the cell is not a number and will be centered instead.
+ * Doing this once while parsing saves the formatters from
+ * scanning the string both when measuring and when printing.
+ */
+static void
+getalign(const struct tbl_node *tbl, struct tbl_dat *dat)
+{
+	const char	*cp, *lastdigit, *lastpoint;
+
+	dat->align = -1;
+	if (dat->layout->pos != TBL_CELL_NUMBER || dat->string == NULL)
+		return;
+
+	lastdigit = lastpoint = NULL;
+	for (cp = dat->string; cp[0] != '\0'; cp++) {
+		if (cp[0] == '\\' && cp[1] == '&') {
+			lastdigit = lastpoint = cp;
+			break;
+		} else if (cp[0] == tbl->opts.decimal &&
+		    (isdigit((unsigned char)cp[1]) ||
+		     (cp > dat->string && isdigit((unsigned char)cp[-1]))))
+			lastpoint = cp;
+		else if (isdigit((unsigned char)cp[0]))
+			lastdigit = cp;
+	}
+	if (lastdigit == NULL)
+		return;
+	if (lastpoint == NULL)
+		lastpoint = lastdigit + 1;
+	dat->align = lastpoint - dat->string;
+}
+
 static void
 getdata(struct tbl_node *tbl, struct tbl_span *dp,
 		int ln, const char *p, int *pos)
@@ -97,6 +136,7 @@ getdata(struct tbl_node *tbl, struct tbl_span *dp,
 	dat->layout = cp;
 	dat->next = NULL;
 	dat->string = NULL;
+	dat->align = -1;
 	dat->hspans = 0;
 	dat->vspans = 0;
 	dat->block = 0;
@@ -183,8 +223,10 @@ getdata(struct tbl_node *tbl, struct tbl_span *dp,
 		dat->pos = TBL_DATA_NHORIZ;
 	else if ( ! strcmp(dat->string, "\\="))
 		dat->pos = TBL_DATA_NDHORIZ;
-	else
+	else {
 		dat->pos = TBL_DATA_DATA;
+		getalign(tbl, dat);
+	}
 
 	if ((dat->layout->pos == TBL_CELL_HORIZ ||
 	    dat->layout->pos == TBL_CELL_DHORIZ ||
@@ -231,6 +273,7 @@ tbl_cdata(struct tbl_node *tbl, int ln, const char *p, int pos)
 		(void)strlcat(dat->string, p + pos, sz);
 	} else
 		dat->string = mandoc_strdup(p + pos);
+	getalign(tbl, dat);
 
 	if (dat->layout->pos == TBL_CELL_DOWN)
 		mandoc_msg(MANDOCERR_TBLDATA_SPAN,
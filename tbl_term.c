@@ -20,7 +20,6 @@
 #include <sys/types.h>
 
 #include <assert.h>
-#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -39,8 +38,7 @@
 
 static	size_t	term_tbl_len(size_t, void *);
 static	size_t	term_tbl_strlen(const char *, void *);
-static	void	tbl_data(struct termp *, const struct tbl_opts *,
-			const struct tbl_cell *,
+static	void	tbl_data(struct termp *, const struct tbl_cell *,
 			const struct tbl_dat *,
 			const struct roffcol *, size_t *);
 static	void	tbl_direct_border(struct termp *, int, size_t);
@@ -53,8 +51,7 @@ static	void	tbl_hrule(struct termp *, const struct tbl_span *,
 			int);
 static	void	tbl_literal(struct termp *, const struct tbl_dat *,
 			const struct roffcol *, size_t *);
-static	void	tbl_number(struct termp *, const struct tbl_opts *,
-			const struct tbl_dat *,
+static	void	tbl_number(struct termp *, const struct tbl_dat *,
 			const struct roffcol *, size_t *);
 static	void	tbl_word(struct termp *, const struct tbl_dat *);
 
@@ -328,8 +325,7 @@ term_tbl(struct termp *tp, const struct tbl_span *sp)
 			tp->tcol++;
 			tp->col = 0;
 			tp->flags &= ~(TERMP_BACKAFTER | TERMP_BACKBEFORE);
-			tbl_data(tp, sp->opts, cp, dp, tp->tbl.cols + ic,
-			    &coloff);
+			tbl_data(tp, cp, dp, tp->tbl.cols + ic, &coloff);
 			coloff += term_len(tp, tp->tbl.cols[ic].spacing);
 			if (dp != NULL &&
 			    (ic || sp->layout->first->pos != TBL_CELL_SPAN)) {
@@ -763,9 +759,8 @@ tbl_hrule(struct termp *tp, const struct tbl_span *spp,
 }
 
 static void
-tbl_data(struct termp *tp, const struct tbl_opts *opts,
-    const struct tbl_cell *cp, const struct tbl_dat *dp,
-    const struct roffcol *col, size_t *coloff)
+tbl_data(struct termp *tp, const struct tbl_cell *cp,
+    const struct tbl_dat *dp, const struct roffcol *col, size_t *coloff)
 {
 	switch (cp->pos) {
 	case TBL_CELL_HORIZ:
@@ -804,7 +799,7 @@ tbl_data(struct termp *tp, const struct tbl_opts *opts,
 		tbl_literal(tp, dp, col, coloff);
 		break;
 	case TBL_CELL_NUMBER:
-		tbl_number(tp, opts, dp, col, coloff);
+		tbl_number(tp, dp, col, coloff);
 		break;
 	case TBL_CELL_DOWN:
 	case TBL_CELL_SPAN:
@@ -906,11 +901,10 @@ tbl_literal(struct termp *tp, const struct tbl_dat *dp,
 }
 
 static void
-tbl_number(struct termp *tp, const struct tbl_opts *opts,
-		const struct tbl_dat *dp,
+tbl_number(struct termp *tp, const struct tbl_dat *dp,
 		const struct roffcol *col, size_t *coloff)
 {
-	const char	*cp, *lastdigit, *lastpoint;
+	const char	*cp, *lastpoint;
 
 	/* Widths in basic units. */
 	size_t		 pad;	/* Padding before the number. */
@@ -921,30 +915,15 @@ tbl_number(struct termp *tp, const struct tbl_opts *opts,
 
 	/*
 	 * Almost the same code as in tblcalc_number():
-	 * First find the position of the decimal point.
+	 * measure both widths, using the position
+	 * of the decimal point found by the parser.
 	 */
 
 	assert(dp->string);
-	lastdigit = lastpoint = NULL;
-	for (cp = dp->string; cp[0] != '\0'; cp++) {
-		if (cp[0] == '\\' && cp[1] == '&') {
-			lastdigit = lastpoint = cp;
-			break;
-		} else if (cp[0] == opts->decimal &&
-		    (isdigit((unsigned char)cp[1]) ||
-		     (cp > dp->string && isdigit((unsigned char)cp[-1]))))
-			lastpoint = cp;
-		else if (isdigit((unsigned char)cp[0]))
-			lastdigit = cp;
-	}
-
-	/* Then measure both widths. */
-
 	pad = 0;
 	totsz = term_strlen(tp, dp->string);
-	if (lastdigit != NULL) {
-		if (lastpoint == NULL)
-			lastpoint = lastdigit + 1;
+	if (dp->align != -1) {
+		lastpoint = dp->string + dp->align;
 		intsz = 0;
 		buf[1] = '\0';
 		for (cp = dp->string; cp < lastpoint; cp++) {
@@ -21,6 +21,7 @@
 
 #include <assert.h>
 #include <ctype.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -28,10 +29,19 @@
 
 #include "mandoc.h"
 #include "mandoc_aux.h"
+#include "mandoc_ohash.h"
+#include "roff.h"
 #include "out.h"
 #include "term.h"
 #include "main.h"
 
+struct	term_width {
+	size_t		 width;		/* In basic units. */
+	enum termfont	 font;		/* Font in effect when measured. */
+	enum termenc	 enc;		/* Output encoding. */
+	char		 s[];
+};
+
 static	size_t		 cond_width(const struct termp *, int, int *);
 static	void		 adjbuf(struct termp_col *, size_t);
 static	void		 bufferc(struct termp *, char);
@@ -41,6 +51,11 @@ static	void		 endline(struct termp *);
 static	void		 term_field(struct termp *, size_t, size_t);
 static	void		 term_fill(struct termp *, size_t *, size_t *,
 				size_t);
+static	size_t		 term_measure(const struct termp *, const char *);
+static	void		 term_widths_free(struct ohash *);
+static	enum mandoc_esc	 term_escape(const struct termp *, const char *,
+				const char **, const struct roff_esc **,
+				const char **, int *, int *);
 
 
 void
@@ -59,10 +74,14 @@ void
 term_free(struct termp *p)
 {
 	term_tab_free();
+	term_widths_free(p->widths);
+	free(p->widths);
 	for (p->tcol = p->tcols; p->tcol < p->tcols + p->maxtcol; p->tcol++)
 		free(p->tcol->buf);
 	free(p->tcols);
 	free(p->fontq);
+	free(p->obuf);
+	free(p->mt);
 	free(p);
 }
 
@@ -556,9 +575,65 @@ term_fontpop(struct termp *p)
  */
 void
 term_word(struct termp *p, const char *word)
+{
+	term_word_esc(p, word, NULL);
+}
+
+/*
+ * Parse the escape sequence starting at *word, or take it from the
+ * array *dec decoded by the parser, if any, and advance the pointers.
+ * For character escape sequences, also provide the code point in *uc.
+ * In ASCII mode, that is not needed for special characters.
+ */
+static enum mandoc_esc
+term_escape(const struct termp *p, const char *start, const char **word,
+    const struct roff_esc **dec, const char **seq, int *sz, int *uc)
+{
+	enum mandoc_esc	 esc;
+
+	if (*dec != NULL && (*dec)->end > 0) {
+		esc = (*dec)->type;
+		*seq = start + (*dec)->arg;
+		*sz = (*dec)->sz;
+		*word = start + (*dec)->end;
+		*uc = (*dec)->uc;
+		(*dec)++;
+		return esc;
+	}
+
+	(*word)++;
+	esc = mandoc_escape(word, seq, sz);
+	switch (esc) {
+	case ESCAPE_UNICODE:
+		*uc = mchars_num2uc(*seq + 1, *sz - 1);
+		break;
+	case ESCAPE_NUMBERED:
+		*uc = mchars_num2char(*seq, *sz);
+		break;
+	case ESCAPE_SPECIAL:
+		*uc = p->enc == TERMENC_ASCII ? -1 :
+		    mchars_spec2cp(*seq, *sz);
+		break;
+	case ESCAPE_UNDEF:
+		*uc = **seq;
+		break;
+	default:
+		*uc = -1;
+		break;
+	}
+	return esc;
+}
+
+/*
+ * Like term_word(), but take the escape sequences from the array dec
+ * decoded by the parser for this word, if it is not NULL.
+ */
+void
+term_word_esc(struct termp *p, const char *word, const struct roff_esc *dec)
 {
 	struct roffsu	 su;
 	const char	 nbrsp[2] = { ASCII_NBRSP, 0 };
+	const char	*start;		/* Beginning of the word. */
 	const char	*seq;		/* Escape sequence argument. */
 	const char	*cp;		/* String to be printed. */
 	size_t		 csz;		/* String length in basic units. */
@@ -588,6 +663,7 @@ term_word(struct termp *p, const char *word)
 		p->skipvsp = 0;
 	}
 
+	start = word;
 	while ('\0' != *word) {
 		if ('\\' != *word) {
 			if (TERMP_NBRWORD & p->flags) {
@@ -604,14 +680,11 @@ term_word(struct termp *p, const char *word)
 			continue;
 		}
 
-		word++;
-		esc = mandoc_escape(&word, &seq, &sz);
+		esc = term_escape(p, start, &word, &dec, &seq, &sz, &uc);
 		switch (esc) {
 		case ESCAPE_UNICODE:
-			uc = mchars_num2uc(seq + 1, sz - 1);
 			break;
 		case ESCAPE_NUMBERED:
-			uc = mchars_num2char(seq, sz);
 			if (uc >= 0)
 				break;
 			bufferc(p, ASCII_NBRZW);
@@ -623,16 +696,12 @@ term_word(struct termp *p, const char *word)
 					encode(p, cp, ssz);
 				else
 					bufferc(p, ASCII_NBRZW);
-			} else {
-				uc = mchars_spec2cp(seq, sz);
-				if (uc > 0)
-					encode1(p, uc);
-				else
-					bufferc(p, ASCII_NBRZW);
-			}
+			} else if (uc > 0)
+				encode1(p, uc);
+			else
+				bufferc(p, ASCII_NBRZW);
 			continue;
 		case ESCAPE_UNDEF:
-			uc = *seq;
 			break;
 		case ESCAPE_FONTBOLD:
 		case ESCAPE_FONTCB:
@@ -982,9 +1051,74 @@ cond_width(const struct termp *p, int c, int *skip)
 		return (*p->getwidth)(p, c);
 }
 
+/*
+ * Return the width of a string in basic units.
+ * Decoding escape sequences is expensive and table cells are measured
+ * more than once, so remember the widths of such strings for each
+ * formatter, keyed by the string, the font, and the encoding.
+ * Plain strings are faster to measure than to look up.
+ * Throw the cache away when it grows too large.
+ */
 size_t
 term_strlen(const struct termp *p, const char *cp)
 {
+	struct ohash		*h;
+	struct term_width	*tw;
+	const char		*end;
+	size_t			 len;
+	unsigned int		 slot;
+	uint32_t		 hv;
+	enum termfont		 font;
+
+	if (strchr(cp, '\\') == NULL)
+		return term_measure(p, cp);
+
+	h = p->widths;
+	if (h->info.free != NULL && ohash_entries(h) >= 1 << 14)
+		term_widths_free(h);
+	if (h->info.free == NULL)
+		mandoc_ohash_init(h, 6, offsetof(struct term_width, s));
+
+	font = p->fontq[p->fonti];
+	end = NULL;
+	hv = ohash_interval(cp, &end);
+	hv = 37 * (37 * hv + font) + p->enc;
+	slot = ohash_lookup_interval(h, cp, end, hv);
+	if ((tw = ohash_find(h, slot)) == NULL) {
+		len = end - cp;
+		tw = mandoc_malloc(sizeof(*tw) + len + 1);
+		memcpy(tw->s, cp, len + 1);
+		tw->width = term_measure(p, cp);
+		tw->font = font;
+		tw->enc = p->enc;
+		ohash_insert(h, slot, tw);
+	} else if (tw->font != font || tw->enc != p->enc)
+		return term_measure(p, cp);  /* Hash collision. */
+	return tw->width;
+}
+
+static void
+term_widths_free(struct ohash *h)
+{
+	struct term_width	*tw;
+	unsigned int		 slot;
+
+	if (h->info.free == NULL)
+		return;
+	tw = ohash_first(h, &slot);
+	while (tw != NULL) {
+		free(tw);
+		tw = ohash_next(h, &slot);
+	}
+	ohash_delete(h);
+	h->info.free = NULL;
+}
+
+static size_t
+term_measure(const struct termp *p, const char *cp)
+{
+	const struct roff_esc *dec;	/* Not decoded in advance. */
+	const char	*start;		/* Beginning of the string. */
 	const char	*seq;		/* Escape sequence argument. */
 	const char	*rhs;		/* String to be printed. */
 
@@ -1013,6 +1147,8 @@ term_strlen(const struct termp *p, const char *cp)
 
 	sz = 0;
 	skip = 0;
+	dec = NULL;
+	start = cp;
 	while ('\0' != *cp) {
 		rsz = strcspn(cp, rej);
 		for (i = 0; i < rsz; i++)
@@ -1020,15 +1156,13 @@ term_strlen(const struct termp *p, const char *cp)
 
 		switch (*cp) {
 		case '\\':
-			cp++;
 			rhs = NULL;
-			esc = mandoc_escape(&cp, &seq, &ssz);
+			esc = term_escape(p, start, &cp, &dec,
+			    &seq, &ssz, &uc);
 			switch (esc) {
 			case ESCAPE_UNICODE:
-				uc = mchars_num2uc(seq + 1, ssz - 1);
 				break;
 			case ESCAPE_NUMBERED:
-				uc = mchars_num2char(seq, ssz);
 				if (uc < 0)
 					continue;
 				break;
@@ -1037,14 +1171,10 @@ term_strlen(const struct termp *p, const char *cp)
 					rhs = mchars_spec2str(seq, ssz, &rsz);
 					if (rhs != NULL)
 						break;
-				} else {
-					uc = mchars_spec2cp(seq, ssz);
-					if (uc > 0)
-						sz += cond_width(p, uc, &skip);
-				}
+				} else if (uc > 0)
+					sz += cond_width(p, uc, &skip);
 				continue;
 			case ESCAPE_UNDEF:
-				uc = *seq;
 				break;
 			case ESCAPE_DEVICE:
 				if (p->type == TERMTYPE_PDF) {
@@ -38,6 +38,9 @@ enum	termfont {
 };
 
 struct	eqn_box;
+struct	mtermp;
+struct	ohash;
+struct	roff_esc;
 struct	roff_meta;
 struct	roff_node;
 struct	tbl_span;
@@ -118,6 +121,14 @@ struct	termp {
 				const struct roffsu *);
 	const void	 *argf;		/* arg for headf/footf */
 	const char	 *mc;		/* Margin character. */
+	char		 *obuf;		/* Output line buffer. */
+	size_t		  obufsz;	/* Allocated bytes in obuf. */
+	size_t		  obuflen;	/* Bytes waiting in obuf. */
+	char		**omem;		/* Caller-supplied output memory. */
+	size_t		 *omemsz;	/* Bytes used in *omem. */
+	const struct roff_node *lastpart; /* Last node printed early. */
+	struct mtermp	 *mt;		/* man(7) state between parts. */
+	struct ohash	 *widths;	/* Of strings with escapes. */
 	struct termp_ps	 *ps;
 };
 
@@ -133,6 +144,8 @@ void		  term_setcol(struct termp *, size_t);
 void		  term_newln(struct termp *);
 void		  term_vspace(struct termp *);
 void		  term_word(struct termp *, const char *);
+void		  term_word_esc(struct termp *, const char *,
+			const struct roff_esc *);
 void		  term_flushln(struct termp *);
 void		  term_begin(struct termp *, term_margin,
 			term_margin, const struct roff_meta *);
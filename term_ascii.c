@@ -25,6 +25,7 @@
 #include <langinfo.h>
 #include <locale.h>
 #endif
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -36,6 +37,7 @@
 
 #include "mandoc.h"
 #include "mandoc_aux.h"
+#include "mandoc_ohash.h"
 #include "out.h"
 #include "term.h"
 #include "manconf.h"
@@ -49,7 +51,9 @@ static	void		  ascii_advance(struct termp *, size_t);
 static	void		  ascii_begin(struct termp *);
 static	void		  ascii_end(struct termp *);
 static	void		  ascii_endline(struct termp *);
+static	void		  ascii_flush(struct termp *);
 static	void		  ascii_letter(struct termp *, int);
+static	void		  ascii_reserve(struct termp *, size_t);
 static	void		  ascii_setwidth(struct termp *, int, size_t);
 
 #if HAVE_WCHAR
@@ -71,6 +75,7 @@ ascii_init(enum termenc enc, const struct manoutput *outopts)
 	p = mandoc_calloc(1, sizeof(*p));
 	p->tcol = p->tcols = mandoc_calloc(1, sizeof(*p->tcol));
 	p->maxtcol = 1;
+	p->widths = mandoc_calloc(1, sizeof(*p->widths));
 
 	p->line = 1;
 	p->defindent = 5;
@@ -202,13 +207,65 @@ ascii_getwidth(const struct termp *p, int c)
 void
 ascii_free(void *arg)
 {
+	ascii_flush((struct termp *)arg);
 	term_free((struct termp *)arg);
 }
 
+/*
+ * Redirect terminal output into memory: each completed output line
+ * is appended to the NUL-terminated string *bufp, which is grown
+ * with mandoc_realloc(), and *szp is kept at its length.
+ * The caller owns the string.  With bufp == NULL, output goes
+ * to standard output again.
+ */
+void
+ascii_setmem(void *arg, char **bufp, size_t *szp)
+{
+	struct termp	*p;
+
+	p = (struct termp *)arg;
+	ascii_flush(p);
+	p->omem = bufp;
+	p->omemsz = bufp == NULL ? NULL : szp;
+}
+
+/*
+ * Make room for at least sz more bytes in the line buffer.
+ */
+static void
+ascii_reserve(struct termp *p, size_t sz)
+{
+	if (p->obuflen + sz <= p->obufsz)
+		return;
+	while (p->obuflen + sz > p->obufsz)
+		p->obufsz = p->obufsz == 0 ? 256 : p->obufsz * 2;
+	p->obuf = mandoc_realloc(p->obuf, p->obufsz);
+}
+
+/*
+ * Hand the buffered output line to its destination in one call.
+ */
+static void
+ascii_flush(struct termp *p)
+{
+	if (p->obuflen == 0)
+		return;
+	if (p->omem != NULL) {
+		*p->omem = mandoc_realloc(*p->omem,
+		    *p->omemsz + p->obuflen + 1);
+		memcpy(*p->omem + *p->omemsz, p->obuf, p->obuflen);
+		*p->omemsz += p->obuflen;
+		(*p->omem)[*p->omemsz] = '\0';
+	} else
+		fwrite(p->obuf, 1, p->obuflen, stdout);
+	p->obuflen = 0;
+}
+
 static void
 ascii_letter(struct termp *p, int c)
 {
-	putchar(c);
+	ascii_reserve(p, 1);
+	p->obuf[p->obuflen++] = c;
 }
 
 static void
@@ -221,6 +278,7 @@ static void
 ascii_end(struct termp *p)
 {
 	(*p->footf)(p, p->argf);
+	ascii_flush(p);
 }
 
 static void
@@ -234,7 +292,8 @@ ascii_endline(struct termp *p)
 	p->ti = 0;
 	p->minbl = 0;
 	p->viscol = 0;
-	putchar('\n');
+	ascii_letter(p, '\n');
+	ascii_flush(p);
 }
 
 static void
@@ -256,7 +315,7 @@ ascii_advance(struct termp *p, size_t len)
 
 	dst = p->viscol + len;
 	while (p->viscol + sz / 2 < dst) {
-		putchar(' ');
+		ascii_letter(p, ' ');
 		p->viscol += sz;
 	}
 }
@@ -408,7 +467,7 @@ locale_advance(struct termp *p, size_t len)
 
 	dst = p->viscol + len;
 	while (p->viscol + sz / 2 < dst) {
-		putwchar(L' ');
+		ascii_letter(p, ' ');
 		p->viscol += sz;
 	}
 }
@@ -424,12 +483,28 @@ locale_endline(struct termp *p)
 	p->ti = 0;
 	p->minbl = 0;
 	p->viscol = 0;
-	putwchar(L'\n');
+	ascii_letter(p, '\n');
+	ascii_flush(p);
 }
 
+/*
+ * Encode the character right into the line buffer
+ * rather than going through wide-character stdio.
+ */
 static void
 locale_letter(struct termp *p, int c)
 {
-	putwchar(c);
+	mbstate_t	 mbs;
+	size_t		 sz;
+
+	if (c >= 0 && c < 0x80) {
+		ascii_letter(p, c);
+		return;
+	}
+	ascii_reserve(p, MB_CUR_MAX);
+	memset(&mbs, 0, sizeof(mbs));
+	sz = wcrtomb(p->obuf + p->obuflen, c, &mbs);
+	if (sz != (size_t)-1)
+		p->obuflen += sz;
 }
 #endif
@@ -26,13 +26,17 @@
 #include <err.h>
 #endif
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <zlib.h>
 
 #include "mandoc_aux.h"
+#include "mandoc_ohash.h"
+#include "roff.h"
 #include "out.h"
 #include "term.h"
 #include "manconf.h"
@@ -41,6 +45,9 @@
 /* These work the buffer used by the header and footer. */
 #define	PS_BUFSLOP	  128
 
+/* Size of the output buffer, see ps_write(). */
+#define	PS_OBUFSZ	  (1 << 16)
+
 /* Convert PostScript point "x" to an AFM unit. */
 #define	PNT2AFM(p, x) \
 	(size_t)((double)(x) * (1000.0 / (double)(p)->ps->scale))
@@ -59,6 +66,11 @@ struct	font {
 	struct glyph	  gly[MAXCHAR]; /* glyph metrics */
 };
 
+struct	psdoc {
+	char		 *title;	/* for the PDF outline */
+	size_t		  page;		/* first page of the document */
+};
+
 struct	termp_ps {
 	int		  flags;
 #define	PS_INLINE	 (1 << 0)	/* we're in a word */
@@ -88,8 +100,13 @@ struct	termp_ps {
 	size_t		  header;	/* header pos (AFM units) */
 	size_t		  footer;	/* footer pos (AFM units) */
 	size_t		  pdfbytes;	/* current output byte */
-	size_t		  pdflastpg;	/* byte of last page mark */
 	size_t		  pdfbody;	/* start of body object */
+	char		 *pdfpage;	/* content stream of the page */
+	size_t		  pdfpagesz;	/* allocated bytes in pdfpage */
+	size_t		  pdfpagecur;	/* used bytes in pdfpage */
+	int		  pdfstream;	/* collecting into pdfpage */
+	struct psdoc	 *docs;		/* documents begun so far */
+	size_t		  docsz;	/* number of entries in docs */
 	size_t		 *pdfobjs;	/* table of object offsets */
 	size_t		  pdfobjsz;	/* size of pdfobjs */
 };
@@ -102,7 +119,9 @@ static	void		  ps_begin(struct termp *);
 static	void		  ps_closepage(struct termp *);
 static	void		  ps_end(struct termp *);
 static	void		  ps_endline(struct termp *);
+static	void		  ps_flush(struct termp *);
 static	void		  ps_growbuf(struct termp *, size_t);
+static	void		  ps_header(struct termp *);
 static	void		  ps_letter(struct termp *, int);
 static	void		  ps_pclose(struct termp *);
 static	void		  ps_plast(struct termp *);
@@ -110,9 +129,15 @@ static	void		  ps_pletter(struct termp *, int);
 static	void		  ps_printf(struct termp *, const char *, ...)
 				__attribute__((__format__ (__printf__, 2, 3)));
 static	void		  ps_putchar(struct termp *, char);
+static	void		  ps_putnum(struct termp *, size_t);
+static	void		  ps_putpnt(struct termp *, size_t);
+static	void		  ps_putstr(struct termp *, const char *);
 static	void		  ps_setfont(struct termp *, enum termfont);
 static	void		  ps_setwidth(struct termp *, int, size_t);
+static	void		  ps_trailer(struct termp *);
+static	void		  ps_write(struct termp *, const char *, size_t);
 static	struct termp	 *pspdf_alloc(const struct manoutput *, enum termtype);
+static	void		  pdf_growpage(struct termp *, size_t);
 static	void		  pdf_obj(struct termp *, size_t);
 
 /*
@@ -535,6 +560,7 @@ pspdf_alloc(const struct manoutput *outopts, enum termtype type)
 	p = mandoc_calloc(1, sizeof(*p));
 	p->tcol = p->tcols = mandoc_calloc(1, sizeof(*p->tcol));
 	p->maxtcol = 1;
+	p->widths = mandoc_calloc(1, sizeof(*p->widths));
 	p->type = type;
 
 	p->enc = TERMENC_ASCII;
@@ -542,6 +568,8 @@ pspdf_alloc(const struct manoutput *outopts, enum termtype type)
 	    (p->fontsz = 8), sizeof(*p->fontq));
 	p->fontq[0] = p->fontl = TERMFONT_NONE;
 	p->ps = mandoc_calloc(1, sizeof(*p->ps));
+	p->obufsz = PS_OBUFSZ;
+	p->obuf = mandoc_malloc(p->obufsz);
 
 	p->advance = ps_advance;
 	p->begin = ps_begin;
@@ -644,71 +672,136 @@ void
 pspdf_free(void *arg)
 {
 	struct termp	*p;
+	size_t		 i;
 
 	p = (struct termp *)arg;
 
+	if (p->ps->pdfbody > 0) {
+		ps_trailer(p);
+		ps_flush(p);
+	}
+	for (i = 0; i < p->ps->docsz; i++)
+		free(p->ps->docs[i].title);
+	free(p->ps->docs);
 	free(p->ps->psmarg);
 	free(p->ps->pdfobjs);
+	free(p->ps->pdfpage);
 
 	free(p->ps);
 	term_free(p);
 }
 
+/*
+ * All output goes through ps_write(): into the margin buffer while
+ * printing the header and footer, into the page buffer while
+ * collecting a PDF content stream, and into the output buffer
+ * otherwise.  Only the last one counts towards pdfbytes.
+ */
 static void
-ps_printf(struct termp *p, const char *fmt, ...)
+ps_write(struct termp *p, const char *s, size_t len)
 {
-	va_list		 ap;
-	int		 pos, len;
-
-	va_start(ap, fmt);
-
-	/*
-	 * If we're running in regular mode, then pipe directly into
-	 * vprintf().  If we're processing margins, then push the data
-	 * into our growable margin buffer.
-	 */
-
-	if ( ! (PS_MARGINS & p->ps->flags)) {
-		len = vprintf(fmt, ap);
-		va_end(ap);
-		p->ps->pdfbytes += len < 0 ? 0 : (size_t)len;
-		return;
+	if (PS_MARGINS & p->ps->flags) {
+		ps_growbuf(p, len);
+		memcpy(p->ps->psmarg + p->ps->psmargcur, s, len);
+		p->ps->psmargcur += len;
+	} else if (p->ps->pdfstream) {
+		pdf_growpage(p, len);
+		memcpy(p->ps->pdfpage + p->ps->pdfpagecur, s, len);
+		p->ps->pdfpagecur += len;
+	} else {
+		if (p->obuflen + len > p->obufsz)
+			ps_flush(p);
+		if (len > p->obufsz)
+			fwrite(s, 1, len, stdout);
+		else {
+			memcpy(p->obuf + p->obuflen, s, len);
+			p->obuflen += len;
+		}
+		p->ps->pdfbytes += len;
 	}
+}
 
-	/*
-	 * XXX: I assume that the in-margin print won't exceed
-	 * PS_BUFSLOP (128 bytes), which is reasonable but still an
-	 * assumption that will cause pukeage if it's not the case.
-	 */
-
-	ps_growbuf(p, PS_BUFSLOP);
+static void
+ps_flush(struct termp *p)
+{
+	if (p->obuflen == 0)
+		return;
+	fwrite(p->obuf, 1, p->obuflen, stdout);
+	p->obuflen = 0;
+}
 
-	pos = (int)p->ps->psmargcur;
-	vsnprintf(&p->ps->psmarg[pos], PS_BUFSLOP, fmt, ap);
+static void
+ps_printf(struct termp *p, const char *fmt, ...)
+{
+	va_list		 ap, ap2;
+	char		 buf[PS_BUFSLOP], *cp;
+	int		 len;
 
+	va_start(ap, fmt);
+	va_copy(ap2, ap);
+	len = vsnprintf(buf, sizeof(buf), fmt, ap);
 	va_end(ap);
-
-	p->ps->psmargcur = strlen(p->ps->psmarg);
+	if (len >= 0 && (size_t)len < sizeof(buf))
+		ps_write(p, buf, len);
+	else if (len >= 0) {
+		cp = mandoc_malloc((size_t)len + 1);
+		(void)vsnprintf(cp, (size_t)len + 1, fmt, ap2);
+		ps_write(p, cp, len);
+		free(cp);
+	}
+	va_end(ap2);
 }
 
 static void
 ps_putchar(struct termp *p, char c)
 {
-	int		 pos;
-
-	/* See ps_printf(). */
+	ps_write(p, &c, 1);
+}
 
-	if ( ! (PS_MARGINS & p->ps->flags)) {
-		putchar(c);
-		p->ps->pdfbytes++;
-		return;
-	}
+static void
+ps_putstr(struct termp *p, const char *s)
+{
+	ps_write(p, s, strlen(s));
+}
 
-	ps_growbuf(p, 2);
+/* Print a decimal number without the overhead of printf(3). */
+static void
+ps_putnum(struct termp *p, size_t n)
+{
+	char	 buf[24], *cp;
+
+	cp = buf + sizeof(buf);
+	do {
+		*--cp = '0' + n % 10;
+		n /= 10;
+	} while (n > 0);
+	ps_write(p, cp, buf + sizeof(buf) - cp);
+}
 
-	pos = (int)p->ps->psmargcur++;
-	p->ps->psmarg[pos++] = c;
-	p->ps->psmarg[pos] = '\0';
+/*
+ * Print an AFM unit as PostScript points with three decimals.
+ * Since AFM2PNT() multiplies by scale / 1000, integer arithmetic
+ * is exact and yields the same digits as "%.3f".
+ */
+static void
+ps_putpnt(struct termp *p, size_t x)
+{
+	char	 buf[32], *cp;
+	size_t	 v;
+	int	 i;
+
+	v = x * p->ps->scale;
+	cp = buf + sizeof(buf);
+	for (i = 0; i < 3; i++) {
+		*--cp = '0' + v % 10;
+		v /= 10;
+	}
+	*--cp = '.';
+	do {
+		*--cp = '0' + v % 10;
+		v /= 10;
+	} while (v > 0);
+	ps_write(p, cp, buf + sizeof(buf) - cp);
 }
 
 static void
@@ -730,24 +823,47 @@ pdf_obj(struct termp *p, size_t obj)
 static void
 ps_closepage(struct termp *p)
 {
+	unsigned char	*zbuf;
+	uLongf		 zlen;
 	int		 i;
 	size_t		 len, base;
 
 	/*
 	 * Close out a page that we've already flushed to output.  In
 	 * PostScript, we simply note that the page must be shown.  In
-	 * PDF, we must now create the Length, Resource, and Page node
-	 * for the page contents.
+	 * PDF, we must now write the content stream that was collected
+	 * in memory, preferably compressed, and create the Length,
+	 * Resource, and Page node for the page contents.
 	 */
 
-	assert(p->ps->psmarg && p->ps->psmarg[0]);
-	ps_printf(p, "%s", p->ps->psmarg);
+	assert(p->ps->psmargcur > 0);
+	ps_write(p, p->ps->psmarg, p->ps->psmargcur);
 
 	if (TERMTYPE_PS != p->type) {
-		len = p->ps->pdfbytes - p->ps->pdflastpg;
+		assert(p->ps->pdfstream);
+		p->ps->pdfstream = 0;
 		base = p->ps->pages * 4 + p->ps->pdfbody;
 
-		ps_printf(p, "endstream\nendobj\n");
+		zlen = compressBound(p->ps->pdfpagecur);
+		zbuf = mandoc_malloc(zlen);
+		pdf_obj(p, base);
+		ps_printf(p, "<<\n");
+		ps_printf(p, "/Length %zu 0 R\n", base + 1);
+		if (compress(zbuf, &zlen, (unsigned char *)p->ps->pdfpage,
+		    p->ps->pdfpagecur) == Z_OK) {
+			ps_printf(p, "/Filter /FlateDecode\n");
+			ps_printf(p, ">>\nstream\n");
+			len = zlen;
+			ps_write(p, (char *)zbuf, len);
+		} else {
+			ps_printf(p, ">>\nstream\n");
+			len = p->ps->pdfpagecur;
+			ps_write(p, p->ps->pdfpage, len);
+		}
+		free(zbuf);
+		p->ps->pdfpagecur = 0;
+
+		ps_printf(p, "\nendstream\nendobj\n");
 
 		/* Length of content. */
 		pdf_obj(p, base + 1);
@@ -781,8 +897,6 @@ ps_closepage(struct termp *p)
 static void
 ps_end(struct termp *p)
 {
-	size_t		 i, xref, base;
-
 	ps_plast(p);
 	ps_pclose(p);
 
@@ -798,6 +912,24 @@ ps_end(struct termp *p)
 		ps_closepage(p);
 	}
 
+	ps_flush(p);
+
+	/* Documents that did not produce any pages get no outline entry. */
+
+	if (p->ps->docs[p->ps->docsz - 1].page == p->ps->pages)
+		free(p->ps->docs[--p->ps->docsz].title);
+}
+
+/*
+ * After the last document, write the trailer, including the page
+ * tree and, for more than one document, an outline of the book.
+ */
+static void
+ps_trailer(struct termp *p)
+{
+	const char	*cp;
+	size_t		 i, xref, base, last, outl, nout;
+
 	if (TERMTYPE_PS == p->type) {
 		ps_printf(p, "%%%%Trailer\n");
 		ps_printf(p, "%%%%Pages: %zu\n", p->ps->pages);
@@ -817,26 +949,63 @@ ps_end(struct termp *p)
 	for (i = 0; i < p->ps->pages; i++)
 		ps_printf(p, " %zu 0 R", i * 4 + p->ps->pdfbody + 3);
 
-	base = (p->ps->pages - 1) * 4 + p->ps->pdfbody + 4;
+	base = p->ps->pages * 4 + p->ps->pdfbody;
+	nout = p->ps->docsz > 1 ? p->ps->docsz : 0;
 
 	ps_printf(p, "]\n>>\nendobj\n");
 	pdf_obj(p, base);
 	ps_printf(p, "<<\n");
 	ps_printf(p, "/Type /Catalog\n");
 	ps_printf(p, "/Pages 2 0 R\n");
+	if (nout > 0)
+		ps_printf(p, "/Outlines %zu 0 R\n", base + 1);
 	ps_printf(p, ">>\nendobj\n");
+
+	if (nout > 0) {
+		pdf_obj(p, base + 1);
+		ps_printf(p, "<<\n");
+		ps_printf(p, "/Type /Outlines\n");
+		ps_printf(p, "/First %zu 0 R\n", base + 2);
+		ps_printf(p, "/Last %zu 0 R\n", base + 1 + nout);
+		ps_printf(p, "/Count %zu\n", nout);
+		ps_printf(p, ">>\nendobj\n");
+		outl = base + 2;
+		for (i = 0; i < nout; i++) {
+			pdf_obj(p, outl);
+			ps_printf(p, "<<\n/Title (");
+			for (cp = p->ps->docs[i].title; *cp != '\0'; cp++) {
+				if (*cp == '(' || *cp == ')' || *cp == '\\')
+					ps_putchar(p, '\\');
+				ps_putchar(p, *cp < ' ' || *cp > '~' ?
+				    '?' : *cp);
+			}
+			ps_printf(p, ")\n");
+			ps_printf(p, "/Parent %zu 0 R\n", base + 1);
+			if (outl > base + 2)
+				ps_printf(p, "/Prev %zu 0 R\n", outl - 1);
+			if (outl < base + 1 + nout)
+				ps_printf(p, "/Next %zu 0 R\n", outl + 1);
+			ps_printf(p, "/Dest [%zu 0 R /XYZ null null null]\n",
+			    p->ps->docs[i].page * 4 + p->ps->pdfbody + 3);
+			ps_printf(p, ">>\nendobj\n");
+			outl++;
+		}
+		last = base + 1 + nout;
+	} else
+		last = base;
+
 	xref = p->ps->pdfbytes;
 	ps_printf(p, "xref\n");
-	ps_printf(p, "0 %zu\n", base + 1);
+	ps_printf(p, "0 %zu\n", last + 1);
 	ps_printf(p, "0000000000 65535 f \n");
 
-	for (i = 0; i < base; i++)
+	for (i = 0; i < last; i++)
 		ps_printf(p, "%.10zu 00000 n \n",
 		    p->ps->pdfobjs[(int)i]);
 
 	ps_printf(p, "trailer\n");
 	ps_printf(p, "<<\n");
-	ps_printf(p, "/Size %zu\n", base + 1);
+	ps_printf(p, "/Size %zu\n", last + 1);
 	ps_printf(p, "/Root %zu 0 R\n", base);
 	ps_printf(p, "/Info 1 0 R\n");
 	ps_printf(p, ">>\n");
@@ -845,51 +1014,13 @@ ps_end(struct termp *p)
 	ps_printf(p, "%%%%EOF\n");
 }
 
+/* Print the file header and, for PDF, the font objects. */
 static void
-ps_begin(struct termp *p)
+ps_header(struct termp *p)
 {
 	size_t		 width, height;
 	int		 i;
 
-	/*
-	 * Print margins into margin buffer.  Nothing gets output to the
-	 * screen yet, so we don't need to initialise the primary state.
-	 */
-
-	if (p->ps->psmarg) {
-		assert(p->ps->psmargsz);
-		p->ps->psmarg[0] = '\0';
-	}
-
-	/*p->ps->pdfbytes = 0;*/
-	p->ps->psmargcur = 0;
-	p->ps->flags = PS_MARGINS;
-	p->ps->pscol = p->ps->left;
-	p->ps->psrow = p->ps->header;
-	p->ps->lastrow = 0; /* impossible row */
-
-	ps_setfont(p, TERMFONT_NONE);
-
-	(*p->headf)(p, p->argf);
-	(*p->endline)(p);
-
-	p->ps->pscol = p->ps->left;
-	p->ps->psrow = p->ps->footer;
-
-	(*p->footf)(p, p->argf);
-	(*p->endline)(p);
-
-	p->ps->flags &= ~PS_MARGINS;
-
-	assert(0 == p->ps->flags);
-	assert(p->ps->psmarg);
-	assert('\0' != p->ps->psmarg[0]);
-
-	/*
-	 * Print header and initialise page state.  Following this,
-	 * stuff gets printed to the screen, so make sure we're sane.
-	 */
-
 	if (TERMTYPE_PS == p->type) {
 		width = AFM2PNT(p, p->ps->width);
 		height = AFM2PNT(p, p->ps->height);
@@ -930,7 +1061,7 @@ ps_begin(struct termp *p)
 		ps_printf(p, "%%%%EndFeature\n");
 		ps_printf(p, "%%%%EndSetup\n");
 	} else {
-		ps_printf(p, "%%PDF-1.1\n");
+		ps_printf(p, "%%PDF-1.2\n");
 		pdf_obj(p, 1);
 		ps_printf(p, "<<\n");
 		ps_printf(p, ">>\n");
@@ -946,8 +1077,67 @@ ps_begin(struct termp *p)
 			ps_printf(p, ">>\nendobj\n");
 		}
 	}
-
 	p->ps->pdfbody = (size_t)TERMFONT__MAX + 3;
+}
+
+static void
+ps_begin(struct termp *p)
+{
+	const struct roff_meta	*meta;
+	struct psdoc		*doc;
+
+	/*
+	 * Print margins into margin buffer.  Nothing gets output to the
+	 * screen yet, so we don't need to initialise the primary state.
+	 */
+
+	/*p->ps->pdfbytes = 0;*/
+	p->ps->psmargcur = 0;
+	p->ps->flags = PS_MARGINS;
+	p->ps->pscol = p->ps->left;
+	p->ps->psrow = p->ps->header;
+	p->ps->lastrow = 0; /* impossible row */
+
+	ps_setfont(p, TERMFONT_NONE);
+
+	(*p->headf)(p, p->argf);
+	(*p->endline)(p);
+
+	p->ps->pscol = p->ps->left;
+	p->ps->psrow = p->ps->footer;
+
+	(*p->footf)(p, p->argf);
+	(*p->endline)(p);
+
+	p->ps->flags &= ~PS_MARGINS;
+
+	assert(0 == p->ps->flags);
+	assert(p->ps->psmargcur > 0);
+
+	/*
+	 * All documents go into one book.  Remember where each
+	 * of them begins for the outline of the PDF file.
+	 */
+
+	meta = p->argf;
+	p->ps->docs = mandoc_reallocarray(p->ps->docs,
+	    p->ps->docsz + 1, sizeof(*p->ps->docs));
+	doc = p->ps->docs + p->ps->docsz++;
+	if (meta->msec == NULL || *meta->msec == '\0')
+		doc->title = mandoc_strdup(meta->title);
+	else
+		mandoc_asprintf(&doc->title, "%s(%s)",
+		    meta->title, meta->msec);
+	doc->page = p->ps->pages;
+
+	/*
+	 * Print the header before the first document and initialise
+	 * page state.  Following this, stuff gets printed to the
+	 * screen, so make sure we're sane.
+	 */
+
+	if (p->ps->pdfbody == 0)
+		ps_header(p);
 	p->ps->pscol = p->ps->left;
 	p->ps->psrow = p->ps->top;
 	p->ps->flags |= PS_NEWPAGE;
@@ -969,15 +1159,8 @@ ps_pletter(struct termp *p, int c)
 			ps_printf(p, "%%%%Page: %zu %zu\n",
 			    p->ps->pages + 1, p->ps->pages + 1);
 			ps_printf(p, "f%d\n", (int)p->ps->lastf);
-		} else {
-			pdf_obj(p, p->ps->pdfbody +
-			    p->ps->pages * 4);
-			ps_printf(p, "<<\n");
-			ps_printf(p, "/Length %zu 0 R\n",
-			    p->ps->pdfbody + 1 + p->ps->pages * 4);
-			ps_printf(p, ">>\nstream\n");
-		}
-		p->ps->pdflastpg = p->ps->pdfbytes;
+		} else
+			p->ps->pdfstream = 1;
 		p->ps->flags &= ~PS_NEWPAGE;
 	}
 
@@ -988,17 +1171,22 @@ ps_pletter(struct termp *p, int c)
 
 	if ( ! (PS_INLINE & p->ps->flags)) {
 		if (TERMTYPE_PS != p->type) {
-			ps_printf(p, "BT\n/F%d %zu Tf\n",
-			    (int)p->ps->lastf, p->ps->scale);
-			ps_printf(p, "%.3f %.3f Td\n(",
-			    AFM2PNT(p, p->ps->pscol),
-			    AFM2PNT(p, p->ps->psrow));
+			ps_putstr(p, "BT\n/F");
+			ps_putnum(p, p->ps->lastf);
+			ps_putchar(p, ' ');
+			ps_putnum(p, p->ps->scale);
+			ps_putstr(p, " Tf\n");
+			ps_putpnt(p, p->ps->pscol);
+			ps_putchar(p, ' ');
+			ps_putpnt(p, p->ps->psrow);
+			ps_putstr(p, " Td\n(");
 		} else {
-			ps_printf(p, "%.3f", AFM2PNT(p, p->ps->pscol));
-			if (p->ps->psrow != p->ps->lastrow)
-				ps_printf(p, " %.3f",
-				    AFM2PNT(p, p->ps->psrow));
-			ps_printf(p, "(");
+			ps_putpnt(p, p->ps->pscol);
+			if (p->ps->psrow != p->ps->lastrow) {
+				ps_putchar(p, ' ');
+				ps_putpnt(p, p->ps->psrow);
+			}
+			ps_putchar(p, '(');
 		}
 		p->ps->flags |= PS_INLINE;
 	}
@@ -1048,11 +1236,11 @@ ps_pclose(struct termp *p)
 		return;
 
 	if (TERMTYPE_PS != p->type)
-		ps_printf(p, ") Tj\nET\n");
+		ps_putstr(p, ") Tj\nET\n");
 	else if (p->ps->psrow == p->ps->lastrow)
-		ps_printf(p, ")c\n");
+		ps_putstr(p, ")c\n");
 	else {
-		ps_printf(p, ")s\n");
+		ps_putstr(p, ")s\n");
 		p->ps->lastrow = p->ps->psrow;
 	}
 
@@ -1278,11 +1466,17 @@ ps_setfont(struct termp *p, enum termfont f)
 	if (PS_NEWPAGE & p->ps->flags)
 		return;
 
-	if (TERMTYPE_PS == p->type)
-		ps_printf(p, "f%d\n", (int)f);
-	else
-		ps_printf(p, "/F%d %zu Tf\n",
-		    (int)f, p->ps->scale);
+	if (TERMTYPE_PS == p->type) {
+		ps_putchar(p, 'f');
+		ps_putnum(p, f);
+		ps_putchar(p, '\n');
+	} else {
+		ps_putstr(p, "/F");
+		ps_putnum(p, f);
+		ps_putchar(p, ' ');
+		ps_putnum(p, p->ps->scale);
+		ps_putstr(p, " Tf\n");
+	}
 }
 
 static size_t
@@ -1363,3 +1557,16 @@ ps_growbuf(struct termp *p, size_t sz)
 	p->ps->psmargsz += sz;
 	p->ps->psmarg = mandoc_realloc(p->ps->psmarg, p->ps->psmargsz);
 }
+
+static void
+pdf_growpage(struct termp *p, size_t sz)
+{
+	if (p->ps->pdfpagecur + sz <= p->ps->pdfpagesz)
+		return;
+
+	if (sz < PS_BUFSLOP)
+		sz = PS_BUFSLOP;
+
+	p->ps->pdfpagesz = 2 * p->ps->pdfpagesz + sz;
+	p->ps->pdfpage = mandoc_realloc(p->ps->pdfpage, p->ps->pdfpagesz);
+}
@@ -20,6 +20,7 @@
 #include "config.h"
 
 #include <sys/types.h>
+#include <sys/wait.h>
 
 #include <errno.h>
 #include <fcntl.h>
@@ -30,25 +31,38 @@
 #include <string.h>
 #include <unistd.h>
 
+#include "mandoc_aux.h"
 #include "mandoc.h"
 #include "roff.h"
 #include "roff_int.h"
 #include "tag.h"
 #include "term_tag.h"
 
-static void tag_signal(int) __attribute__((__noreturn__));
+struct	tag_line {
+	struct roff_node *n;	/* Node where a term is defined. */
+	size_t		  line;	/* Output line of that node. */
+};
 
+static void tag_die(int) __attribute__((__noreturn__));
+static void tag_signal(int);
+
+static volatile sig_atomic_t tag_caught; /* Signal not yet handled. */
 static struct tag_files tag_files;
+static struct tag_line *tag_lines;	/* Tags of the current document. */
+static size_t		 tag_linesz;	/* Number of entries used. */
+static size_t		 tag_linemax;	/* Number of entries allocated. */
 
 
 /*
  * Prepare for using a pager.
  * Not all pagers are capable of using a tag file,
  * but for simplicity, create it anyway.
+ * With topipe, leave standard output alone for now:
+ * the caller connects it to a pipe when starting the pager.
  */
 struct tag_files *
 term_tag_init(const char *outfilename, const char *suffix,
-    const char *tagfilename)
+    const char *tagfilename, int topipe)
 {
 	struct sigaction	 sa;
 	int			 ofd;	/* In /tmp/, dup(2)ed to stdout. */
@@ -63,9 +77,12 @@ term_tag_init(const char *outfilename, const char *suffix,
 	memset(&sa, 0, sizeof(sa));
 	sigfillset(&sa.sa_mask);
 	sa.sa_handler = tag_signal;
+	sa.sa_flags = SA_RESTART;
 	sigaction(SIGHUP, &sa, NULL);
 	sigaction(SIGINT, &sa, NULL);
 	sigaction(SIGTERM, &sa, NULL);
+	if (topipe)
+		sigaction(SIGPIPE, &sa, NULL);
 
 	/*
 	 * POSIX requires that a process calling tcsetpgrp(3)
@@ -85,7 +102,9 @@ term_tag_init(const char *outfilename, const char *suffix,
 
 	/* Create both temporary output files. */
 
-	if (outfilename == NULL) {
+	if (topipe)
+		(void)strlcpy(tag_files.ofn, "-", sizeof(tag_files.ofn));
+	else if (outfilename == NULL) {
 		(void)snprintf(tag_files.ofn, sizeof(tag_files.ofn),
 		    "/tmp/man.XXXXXXXXXX%s", suffix);
 		if ((ofd = mkstemps(tag_files.ofn, strlen(suffix))) == -1) {
@@ -128,6 +147,8 @@ term_tag_init(const char *outfilename, const char *suffix,
 		goto fail;
 	}
 	tfd = -1;
+	if (topipe)
+		return &tag_files;
 	if (dup2(ofd, STDOUT_FILENO) == -1) {
 		mandoc_msg(MANDOCERR_DUP, 0, 0, "%s", strerror(errno));
 		goto fail;
@@ -148,20 +169,56 @@ fail:
 	return NULL;
 }
 
+/*
+ * Remember where a tagged node was printed.  The tag file is
+ * only written by term_tag_flush() after the whole document
+ * is formatted because when the formatter runs while parsing
+ * is still in progress, the node may still lose its tag.
+ */
 void
 term_tag_write(struct roff_node *n, size_t line)
 {
-	const char	*cp;
-	int		 len;
-
 	if (tag_files.tfs == NULL)
 		return;
-	cp = n->tag == NULL ? n->child->string : n->tag;
-	if (cp[0] == '\\' && (cp[1] == '&' || cp[1] == 'e'))
-		cp += 2;
-	len = strcspn(cp, " \t\\");
-	fprintf(tag_files.tfs, "%.*s %s %zu\n",
-	    len, cp, tag_files.ofn, line);
+	if (tag_linesz == tag_linemax) {
+		tag_linemax = tag_linemax == 0 ? 64 : tag_linemax * 2;
+		tag_lines = mandoc_reallocarray(tag_lines,
+		    tag_linemax, sizeof(*tag_lines));
+	}
+	tag_lines[tag_linesz].n = n;
+	tag_lines[tag_linesz].line = line;
+	tag_linesz++;
+}
+
+/*
+ * Write the tags of the current document to the tag file.
+ * Call this before the syntax tree is freed.
+ */
+void
+term_tag_flush(void)
+{
+	struct roff_node	*n;
+	const char		*cp;
+	size_t			 i;
+	int			 len;
+
+	for (i = 0; i < tag_linesz; i++) {
+		n = tag_lines[i].n;
+		if ((n->flags & NODE_ID) == 0)
+			continue;
+		cp = n->tag == NULL ? n->child->string : n->tag;
+		if (cp[0] == '\\' && (cp[1] == '&' || cp[1] == 'e'))
+			cp += 2;
+		len = strcspn(cp, " \t\\");
+		fprintf(tag_files.tfs, "%.*s %s %zu\n",
+		    len, cp, tag_files.ofn, tag_lines[i].line);
+	}
+	tag_linesz = 0;
+
+	/* A pager reading from a pipe may look up tags right away. */
+
+	if (tag_files.pager_pid != 0)
+		fflush(tag_files.tfs);
 }
 
 /*
@@ -179,6 +236,9 @@ term_tag_close(void)
 		fclose(tag_files.tfs);
 		tag_files.tfs = NULL;
 	}
+	free(tag_lines);
+	tag_lines = NULL;
+	tag_linesz = tag_linemax = 0;
 	if (tag_files.ofd != -1) {
 		fflush(stdout);
 		if ((irc = dup2(tag_files.ofd, STDOUT_FILENO)) == -1)
@@ -211,12 +271,51 @@ term_tag_unlink(void)
 	}
 }
 
+/*
+ * Handle a signal that arrived while writing to a pager through a pipe:
+ * let the pager see the end of the input and wait for the user
+ * to close it before removing the tag file it may still be reading.
+ */
+void
+term_tag_check(void)
+{
+	if (tag_caught == 0)
+		return;
+	if (tag_files.ofd != -1)
+		(void)dup2(tag_files.ofd, STDOUT_FILENO);
+	while (waitpid(tag_files.pager_pid, NULL, 0) == -1 &&
+	    errno == EINTR)
+		continue;
+	tag_die(tag_caught);
+}
+
+/*
+ * The pager reading from a pipe is in our own process group
+ * and gets the same signals, so leave it to term_tag_check()
+ * to wait for it.  Otherwise, clean up right away.
+ */
 static void
 tag_signal(int signum)
+{
+	if (tag_files.pager_pid != 0 && tag_files.ofn[0] == '-') {
+		tag_caught = signum;
+		return;
+	}
+	tag_die(signum);
+}
+
+static void
+tag_die(int signum)
 {
 	struct sigaction	 sa;
 
 	term_tag_unlink();
+
+	/* The user closed the pager before reading all output. */
+
+	if (signum == SIGPIPE)
+		_exit(mandoc_msg_getrc());
+
 	memset(&sa, 0, sizeof(sa));
 	sigemptyset(&sa.sa_mask);
 	sa.sa_handler = SIG_DFL;
@@ -0,0 +1,12 @@
+#include <sys/types.h>
+#include <sys/stat.h>
+
+int
+main(void)
+{
+	struct stat	 st;
+
+	if (stat(".", &st) == -1)
+		return 1;
+	return st.st_mtim.tv_nsec < 0;
+}